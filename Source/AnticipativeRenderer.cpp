@@ -0,0 +1,275 @@
+#include "AnticipativeRenderer.h"
+
+//Spins for a while after each block, then sleeps until the audio thread hands it a full one
+class AnticipativeRenderer::RenderThread : public juce::Thread
+{
+public:
+    explicit RenderThread(AnticipativeRenderer& ownerToUse)
+        : juce::Thread("XPulse Anticipative Render"),
+          owner(ownerToUse)
+    {
+    }
+
+    // Audio thread: only a thread that went to sleep gets signalled
+    void submit(Block& block)
+    {
+        pending.store(&block);
+
+        if (sleeping.load())
+            blockReady.signal();
+    }
+
+    // Gets the thread out of its wait so it can see threadShouldExit()
+    void interrupt()
+    {
+        signalThreadShouldExit();
+        blockReady.signal();
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            auto* block = waitForBlock();
+            if (block == nullptr)
+                continue;
+
+            if (!owner.discardRender.load(std::memory_order_acquire))
+                owner.render(*block);
+
+            owner.rendering.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    // Roughly 20-50 us of polling, depending on the core
+    static constexpr int kSpinIterations = 20000;
+
+    // Sleeping render threads still check threadShouldExit() this often
+    static constexpr int kMaxWaitMs = 100;
+
+    Block* waitForBlock()
+    {
+        for (int i = 0; i < kSpinIterations; ++i)
+            if (auto* block = pending.exchange(nullptr, std::memory_order_acquire))
+                return block;
+
+        // Flag first, then look again, so a block submitted in between isn't slept through
+        sleeping.store(true);
+
+        if (pending.load() == nullptr)
+            blockReady.wait(kMaxWaitMs);
+
+        sleeping.store(false);
+        return pending.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    AnticipativeRenderer& owner;
+    std::atomic<Block*> pending{ nullptr };
+
+    juce::WaitableEvent blockReady;
+    std::atomic<bool> sleeping{ false };
+};
+
+AnticipativeRenderer::AnticipativeRenderer(RenderFunction renderFunction)
+    : render(std::move(renderFunction))
+{
+}
+
+AnticipativeRenderer::~AnticipativeRenderer()
+{
+    release();
+}
+
+void AnticipativeRenderer::prepare(int numChannels, int maxSteps, int maxBlockSize, double sampleRate)
+{
+    release();
+
+    maxSize = juce::jmax(1, maxBlockSize);
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    overruns.store(0, std::memory_order_relaxed);
+
+    for (auto& block : blocks)
+    {
+        block.sends.setSize(juce::jmax(1, maxSteps) * numChannels, maxSize);
+        block.wet.setSize(numChannels, maxSize);
+    }
+
+    dryDelay.setSize(numChannels, maxSize);
+    reset(maxSize);
+
+    thread = std::make_unique<RenderThread>(*this);
+
+    // A block period is all the render ever gets, so it is scheduled like the audio thread
+    const auto options = juce::Thread::RealtimeOptions()
+        .withApproximateAudioProcessingTime(maxSize, sampleRate);
+
+    if (!thread->startRealtimeThread(options) && !thread->startThread(juce::Thread::Priority::highest))
+        thread.reset();
+}
+
+void AnticipativeRenderer::release()
+{
+    if (thread != nullptr)
+    {
+        thread->interrupt();
+        thread->stopThread(2000);
+        thread.reset();
+    }
+
+    // A block submitted just before the thread stopped is never rendered
+    rendering.store(false, std::memory_order_release);
+    discardRender.store(false, std::memory_order_relaxed);
+}
+
+void AnticipativeRenderer::reset(int newBlockSize)
+{
+    // The render thread keeps the block it has (blocks[1 - captureBlock]) and drops it unrendered if
+    // it hasn't got to it yet. Either way its wet belongs to the old blocks, so there is none to play
+    // for the first new one (which isn't an overrun)
+    const auto inFlight = rendering.load(std::memory_order_acquire);
+
+    if (inFlight)
+        discardRender.store(true, std::memory_order_release);
+
+    blockSize = juce::jlimit(1, juce::jmax(1, maxSize), newBlockSize);
+    position = 0;
+    wetMissing = inFlight;
+
+    maxWaitTicks = (juce::int64)((double)juce::Time::getHighResolutionTicksPerSecond()
+        * kMaxWaitFraction * blockSize / currentSampleRate);
+
+    // Nothing captured before holds on to its schedule, which may be freed any time now (but the block
+    // in flight is the render thread's until it is done, schedule included)
+    for (int b = 0; b < 2; ++b)
+    {
+        if (inFlight && b != captureBlock)
+            continue;
+
+        auto& block = blocks[b];
+        block.wet.clear();
+        block.schedule = nullptr;
+        block.writtenBands = 0;
+        block.sentSteps = 0;
+        block.numSamples = 0;
+    }
+
+    dryDelay.clear();
+}
+
+void AnticipativeRenderer::finish()
+{
+    waitForRender();
+}
+
+void AnticipativeRenderer::waitForRender() const
+{
+    while (rendering.load(std::memory_order_acquire))
+    {
+    }
+}
+
+bool AnticipativeRenderer::waitForRender(juce::int64 maxTicks) const
+{
+    if (!rendering.load(std::memory_order_acquire))
+        return true;
+
+    // Only reached when the render runs over a whole callback
+    const auto deadline = juce::Time::getHighResolutionTicks() + maxTicks;
+
+    while (rendering.load(std::memory_order_acquire))
+        if (juce::Time::getHighResolutionTicks() >= deadline)
+            return false;
+
+    return true;
+}
+
+void AnticipativeRenderer::markOverrun() noexcept
+{
+    if (!wetMissing)
+        overruns.fetch_add(1, std::memory_order_relaxed);
+
+    wetMissing = true;
+}
+
+bool AnticipativeRenderer::isOnlyUsing(const RoutingGraph::Schedule* schedule) const noexcept
+{
+    for (const auto& block : blocks)
+        if (block.schedule != nullptr && block.schedule != schedule)
+            return false;
+
+    return true;
+}
+
+void AnticipativeRenderer::delayDry(juce::AudioBuffer<float>& buffer, int start, int numSamples)
+{
+    jassert(numSamples <= getSpace());
+
+    for (int ch = 0; ch < juce::jmin(buffer.getNumChannels(), dryDelay.getNumChannels()); ++ch)
+    {
+        auto* samples = buffer.getWritePointer(ch, start);
+        auto* delayed = dryDelay.getWritePointer(ch, position);
+
+        for (int i = 0; i < numSamples; ++i)
+            std::swap(samples[i], delayed[i]);
+    }
+}
+
+void AnticipativeRenderer::addWet(juce::AudioBuffer<float>& buffer, int start, int numSamples)
+{
+    jassert(numSamples <= getSpace());
+
+    if (wetMissing)
+        return;
+
+    // A render that is still going this late plays dry for the rest of its block
+    if (!waitForRender(maxWaitTicks))
+    {
+        markOverrun();
+        return;
+    }
+
+    const auto& wet = blocks[1 - captureBlock].wet;
+    for (int ch = 0; ch < juce::jmin(buffer.getNumChannels(), wet.getNumChannels()); ++ch)
+        buffer.addFrom(ch, start, wet, ch, position, numSamples);
+}
+
+void AnticipativeRenderer::advance(int numSamples)
+{
+    position += numSamples;
+    jassert(position <= blockSize);
+
+    if (position < blockSize)
+        return;
+
+    position = 0;
+
+    // The other block's wet has been played out by now and it is captured into next, unless its
+    // render is still going: this block is dropped and captured over again instead, and the next
+    // one has no wet (the late render's belongs to the block before)
+    if (!waitForRender(wetMissing ? 0 : maxWaitTicks))
+    {
+        wetMissing = false;
+        markOverrun();
+        return;
+    }
+
+    wetMissing = false;
+
+    auto& block = blocks[captureBlock];
+    block.numSamples = blockSize;
+
+    if (thread != nullptr)
+    {
+        // The render thread is done with any stale block by now
+        discardRender.store(false, std::memory_order_relaxed);
+        rendering.store(true, std::memory_order_release);
+        thread->submit(block);
+    }
+    else
+    {
+        render(block);
+    }
+
+    captureBlock = 1 - captureBlock;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <JuceHeader.h>
+#include "RoutingGraph.h"
+
+// Runs the hosted plugins one block ahead of the audio callback, on a background thread.
+//
+// The audio thread only captures: the summed sends of every hosted instance go into the capture
+// block. Once a block is full it is handed to the render thread, which runs the instances and sums
+// their returns into the block's wet signal, while the audio thread captures the next block and
+// plays the wet of the previous one. Everything the returns are mixed with is delayed by the same
+// block through delayDry(), so the mode adds exactly one block of latency.
+//
+// The render has a whole host callback to finish as long as the block size matches the chunks the
+// audio thread captures in (the block engine's chunk size). When it isn't finished by the time its
+// wet is needed, the audio thread waits for it, but only for a fraction of a block: past that the
+// block is an overrun and plays dry. A block that fills up while the render thread is still busy is
+// dropped, and the one after it plays dry too (the late render's wet belongs to an earlier block).
+//
+// reset() never waits either: a block still with the render thread is marked stale instead, so the
+// render thread skips it if it hasn't started on it yet and its wet is never played.
+//
+// Like the worker pool, the render thread spins for a while after each block before it goes to
+// sleep, and the audio thread only signals it when it actually went to sleep.
+class AnticipativeRenderer
+{
+public:
+    // One block of captured sends and, once rendered, the returns summed from them
+    struct Block
+    {
+        // numChannels per step of the schedule, in step order
+        juce::AudioBuffer<float> sends;
+        int numChannels = 0;
+        juce::AudioBuffer<float> wet;
+
+        // The routing the block was captured with (swapped in only at a block start)
+        const RoutingGraph::Schedule* schedule = nullptr;
+
+        // Bands written during the block, and the steps that got any signal, as bits
+        juce::uint32 writtenBands = 0;
+        juce::uint64 sentSteps = 0;
+
+        int numSamples = 0;
+    };
+
+    // Renders a full block: wet has to be completely written (called on the render thread)
+    using RenderFunction = std::function<void(Block&)>;
+
+    explicit AnticipativeRenderer(RenderFunction renderFunction);
+    ~AnticipativeRenderer();
+
+    // Sizes the blocks and starts the render thread. Message thread
+    void prepare(int numChannels, int maxSteps, int maxBlockSize, double sampleRate);
+    void release();
+
+    // Starts over from silence with blocks of blockSize. Audio thread: a block in flight is left to the
+    // render thread as a stale one (isRendering() says when it is done with it)
+    void reset(int blockSize);
+
+    // Waits for a block in flight, however long it takes (before the hosted instances get used from
+    // anywhere else). Message thread only, never from the audio callback
+    void finish();
+
+    int getBlockSize() const noexcept { return blockSize; }
+
+    // Samples that can still be captured into the current block
+    int getSpace() const noexcept { return blockSize - position; }
+    int getPosition() const noexcept { return position; }
+
+    Block& getCaptureBlock() noexcept { return blocks[captureBlock]; }
+
+    // Whether a block is with the render thread right now
+    bool isRendering() const noexcept { return rendering.load(std::memory_order_acquire); }
+
+    // True when neither block (captured or rendering) was captured with a schedule other than this one
+    bool isOnlyUsing(const RoutingGraph::Schedule* schedule) const noexcept;
+
+    // Delays samples [start, start + numSamples) of buffer by one block (at most getSpace() samples)
+    void delayDry(juce::AudioBuffer<float>& buffer, int start, int numSamples);
+
+    // Adds the previous block's wet for the same positions, waiting a bounded time for its render
+    // if need be. Adds nothing for a block that overran
+    void addWet(juce::AudioBuffer<float>& buffer, int start, int numSamples);
+
+    // Moves on by numSamples, handing the block to the render thread once it is full (or dropping
+    // it, when the render thread is still busy with the one before)
+    void advance(int numSamples);
+
+    // Blocks played dry because their render overran, since prepare()
+    int getNumOverruns() const noexcept { return overruns.load(std::memory_order_relaxed); }
+
+private:
+    class RenderThread;
+
+    // Share of a block's duration the audio thread waits for a late render before giving up on it
+    static constexpr double kMaxWaitFraction = 0.25;
+
+    void waitForRender() const;
+
+    // Waits for the render until maxWaitTicks have passed. Returns false if it is still going
+    bool waitForRender(juce::int64 maxTicks) const;
+
+    // Flags the current block's wet as missing, counting it once
+    void markOverrun() noexcept;
+
+    RenderFunction render;
+    std::unique_ptr<RenderThread> thread;
+
+    Block blocks[2];
+    int captureBlock = 0;
+
+    // Dry signal one block back, indexed by the block position
+    juce::AudioBuffer<float> dryDelay;
+
+    int blockSize = 0;
+    int maxSize = 0;
+    int position = 0;
+
+    // Longest wait for a late render, in high resolution ticks (set for the block size in reset())
+    juce::int64 maxWaitTicks = 0;
+    double currentSampleRate = 44100.0;
+
+    // The wet to play this block is missing (its render overran, or its block was dropped)
+    bool wetMissing = false;
+    std::atomic<int> overruns{ 0 };
+
+    // The block the render thread has (the other one is captured into), cleared when it is done
+    std::atomic<bool> rendering{ false };
+
+    // The block the render thread has predates a reset(): not rendered unless already started.
+    // Set and cleared only by the audio thread, the render thread just reads it
+    std::atomic<bool> discardRender{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnticipativeRenderer)
+};
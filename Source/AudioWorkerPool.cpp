@@ -0,0 +1,274 @@
+#include "AudioWorkerPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#elif JUCE_ARM && JUCE_MSVC
+ #include <intrin.h>
+#endif
+
+namespace
+{
+    // Tells the core it is in a spin-wait, so it backs off the memory bus and hands its execution
+    // resources to the sibling hyperthread (which may be the very worker being waited for)
+    inline void pauseCpu() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && JUCE_MSVC
+        __yield();
+       #elif JUCE_ARM
+        asm volatile ("yield");
+       #endif
+    }
+}
+
+//Spins on the batch generation for a while after each batch, then sleeps until signalled
+class AudioWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(AudioWorkerPool& ownerToUse, int indexToUse)
+        : juce::Thread("XPulse Audio Worker " + juce::String(indexToUse + 1)),
+          owner(ownerToUse),
+          index(indexToUse)
+    {
+    }
+
+    void run() override
+    {
+        auto seen = owner.generation.load(std::memory_order_acquire);
+
+        while (!threadShouldExit())
+        {
+            if (!waitForBatch(seen))
+                continue;
+
+            seen = owner.generation.load(std::memory_order_acquire);
+
+            while (owner.runNextJob(index))
+            {
+            }
+        }
+    }
+
+    // Wakes the worker if it went to sleep (audio thread, after a new batch is published)
+    void wake()
+    {
+        if (sleeping.load())
+            batchReady.signal();
+    }
+
+    // Gets the worker out of its wait so it can see threadShouldExit()
+    void interrupt()
+    {
+        signalThreadShouldExit();
+        batchReady.signal();
+    }
+
+private:
+    // Roughly 20-50 us of polling, depending on the core
+    static constexpr int kSpinIterations = 20000;
+
+    // Sleeping workers still check threadShouldExit() this often
+    static constexpr int kMaxWaitMs = 100;
+
+    bool waitForBatch(juce::uint32 seen)
+    {
+        for (int i = 0; i < kSpinIterations; ++i)
+            if (owner.generation.load(std::memory_order_acquire) != seen)
+                return true;
+
+        // Flag first, then look again, so a batch published in between isn't slept through
+        sleeping.store(true);
+
+        if (owner.generation.load() == seen)
+            batchReady.wait(kMaxWaitMs);
+
+        sleeping.store(false);
+        return owner.generation.load(std::memory_order_acquire) != seen;
+    }
+
+    AudioWorkerPool& owner;
+    const int index;
+
+    juce::WaitableEvent batchReady;
+    std::atomic<bool> sleeping{ false };
+};
+
+AudioWorkerPool::AudioWorkerPool()
+{
+    for (auto& range : ranges)
+        range.store(0, std::memory_order_relaxed);
+}
+
+AudioWorkerPool::~AudioWorkerPool()
+{
+    stop();
+}
+
+void AudioWorkerPool::start(double sampleRate, int blockSize)
+{
+    stop();
+
+    // The audio thread takes a share of every batch itself
+    const auto wanted = juce::jlimit(0, kMaxWorkers, juce::SystemStats::getNumPhysicalCpus() - 1);
+
+    const auto options = juce::Thread::RealtimeOptions()
+        .withApproximateAudioProcessingTime(juce::jmax(1, blockSize), sampleRate);
+
+    for (int i = 0; i < wanted; ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i);
+
+        // Not every system grants real-time priority, the highest normal one is next best
+        if (!worker->startRealtimeThread(options) && !worker->startThread(juce::Thread::Priority::highest))
+            break;
+
+        workers[numWorkers++] = std::move(worker);
+    }
+}
+
+void AudioWorkerPool::stop()
+{
+    if (numWorkers > 0)
+        DBG("AudioWorkerPool: longest wait for the workers " + juce::String(getLongestWaitSeconds() * 1000.0, 3)
+            + " ms, last " + juce::String(getLastWaitSeconds() * 1000.0, 3) + " ms");
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers[i]->interrupt();
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers[i]->stopThread(2000);
+        workers[i].reset();
+    }
+
+    numWorkers = 0;
+    lastWaitTicks.store(0, std::memory_order_relaxed);
+    longestWaitTicks.store(0, std::memory_order_relaxed);
+}
+
+double AudioWorkerPool::getLastWaitSeconds() const noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds(lastWaitTicks.load(std::memory_order_relaxed));
+}
+
+double AudioWorkerPool::getLongestWaitSeconds() const noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds(longestWaitTicks.load(std::memory_order_relaxed));
+}
+
+void AudioWorkerPool::runJobs(int numJobs, JobFunction function, void* context)
+{
+    if (numJobs <= 0)
+        return;
+
+    if (numWorkers == 0 || numJobs == 1)
+    {
+        for (int i = 0; i < numJobs; ++i)
+            function(context, i);
+
+        return;
+    }
+
+    // Only as many workers as there are jobs to go round
+    const auto numHelpers = juce::jmin(numWorkers, numJobs - 1);
+    const auto numParticipants = numHelpers + 1;
+
+    jobFunction.store(function, std::memory_order_relaxed);
+    jobContext.store(context, std::memory_order_relaxed);
+    jobsRemaining.store(numJobs, std::memory_order_relaxed);
+
+    // Contiguous shares, the audio thread's first (it starts on them straight away)
+    auto assign = [&](int participant, int share)
+        {
+            const auto first = (juce::uint32)(share * numJobs / numParticipants);
+            const auto end = (juce::uint32)((share + 1) * numJobs / numParticipants);
+            ranges[participant].store(packRange(first, end), std::memory_order_release);
+        };
+
+    assign(kMaxWorkers, 0);
+    for (int w = 0; w < kMaxWorkers; ++w)
+    {
+        if (w < numHelpers) assign(w, w + 1);
+        else ranges[w].store(0, std::memory_order_release);
+    }
+
+    generation.fetch_add(1);
+
+    for (int w = 0; w < numHelpers; ++w)
+        workers[w]->wake();
+
+    while (runNextJob(kMaxWorkers))
+    {
+    }
+
+    // Whatever the workers took is bounded by one job each
+    const auto waitStart = juce::Time::getHighResolutionTicks();
+
+    while (jobsRemaining.load(std::memory_order_acquire) > 0)
+        pauseCpu();
+
+    const auto waited = juce::Time::getHighResolutionTicks() - waitStart;
+    lastWaitTicks.store(waited, std::memory_order_relaxed);
+
+    // Only the audio thread writes it (resetLongestWait() aside, which a lost update doesn't hurt)
+    if (waited > longestWaitTicks.load(std::memory_order_relaxed))
+        longestWaitTicks.store(waited, std::memory_order_relaxed);
+}
+
+bool AudioWorkerPool::runNextJob(int participant)
+{
+    auto job = popFront(participant);
+    if (job < 0)
+        job = stealBack(participant);
+
+    if (job < 0)
+        return false;
+
+    // The range was published after the function and context, so the acquire in the pop covers them
+    jobFunction.load(std::memory_order_relaxed)(jobContext.load(std::memory_order_relaxed), job);
+    jobsRemaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+int AudioWorkerPool::popFront(int participant)
+{
+    auto& range = ranges[participant];
+    auto current = range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto front = (juce::uint32)current;
+        const auto end = (juce::uint32)(current >> 32);
+
+        if (front >= end)
+            return -1;
+
+        if (range.compare_exchange_weak(current, packRange(front + 1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+            return (int)front;
+    }
+}
+
+int AudioWorkerPool::stealBack(int participant)
+{
+    // Victims in order from the thief's neighbour, so thieves spread out
+    for (int offset = 1; offset <= kMaxWorkers; ++offset)
+    {
+        auto& range = ranges[(participant + offset) % (kMaxWorkers + 1)];
+        auto current = range.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            const auto front = (juce::uint32)current;
+            const auto end = (juce::uint32)(current >> 32);
+
+            if (front >= end)
+                break;
+
+            if (range.compare_exchange_weak(current, packRange(front, end - 1), std::memory_order_acq_rel, std::memory_order_acquire))
+                return (int)(end - 1);
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Real-time worker threads that run a batch of independent jobs in parallel with the audio thread.
+//
+// The audio thread hands a batch to run(): the job indices are split into one contiguous range
+// per participant (every worker plus the audio thread itself), each participant works through its
+// own range from the front and, once that is empty, steals from the back of the others. A range
+// is a single atomic word, so popping and stealing are one compare-and-swap and nothing locks.
+// run() returns once every job has finished.
+//
+// Between batches the workers spin for a short while (batches arrive every block, so they are
+// usually still spinning when the next one comes) and then sleep on an event, which the audio
+// thread only signals for workers that actually went to sleep.
+class AudioWorkerPool
+{
+public:
+    // Upper bound on workers, whatever the machine has
+    static constexpr int kMaxWorkers = 8;
+
+    AudioWorkerPool();
+    ~AudioWorkerPool();
+
+    // Starts the workers (one per physical core, less the audio thread's) at real-time priority,
+    // sized for the host's block period. Message thread, never while run() may be called
+    void start(double sampleRate, int blockSize);
+    void stop();
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    // How long the audio thread waited for the workers to finish their last jobs, after running out
+    // of jobs of its own: in the latest batch, and the longest since start() or the last
+    // resetLongestWait(). Safe from any thread
+    double getLastWaitSeconds() const noexcept;
+    double getLongestWaitSeconds() const noexcept;
+    void resetLongestWait() noexcept { longestWaitTicks.store(0, std::memory_order_relaxed); }
+
+    // Runs job(index) for index in [0, numJobs) and waits for all of them. Audio thread only.
+    // Runs them serially on the calling thread when there are no workers or only one job
+    template <typename Job>
+    void run(int numJobs, Job&& job)
+    {
+        using JobType = std::remove_reference_t<Job>;
+        runJobs(numJobs, [](void* context, int index) { (*static_cast<JobType*>(context))(index); }, &job);
+    }
+
+private:
+    class Worker;
+
+    using JobFunction = void (*)(void* context, int index);
+
+    // A participant's remaining jobs: front in the low 32 bits, end in the high 32 bits
+    static constexpr juce::uint64 packRange(juce::uint32 front, juce::uint32 end) noexcept { return ((juce::uint64)end << 32) | front; }
+
+    void runJobs(int numJobs, JobFunction function, void* context);
+
+    // Pops from the participant's own range, then steals from the others. Returns false once
+    // there is nothing left to take
+    bool runNextJob(int participant);
+
+    int popFront(int participant);
+    int stealBack(int participant);
+
+    int numWorkers = 0;
+    std::unique_ptr<Worker> workers[kMaxWorkers];
+
+    // Participant kMaxWorkers is the audio thread
+    std::atomic<juce::uint64> ranges[kMaxWorkers + 1];
+
+    std::atomic<JobFunction> jobFunction{ nullptr };
+    std::atomic<void*> jobContext{ nullptr };
+    std::atomic<int> jobsRemaining{ 0 };
+
+    // Bumped for every batch, the workers wake when it moves
+    std::atomic<juce::uint32> generation{ 0 };
+
+    // High resolution ticks the audio thread spent waiting at the end of a batch
+    std::atomic<juce::int64> lastWaitTicks{ 0 };
+    std::atomic<juce::int64> longestWaitTicks{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioWorkerPool)
+};
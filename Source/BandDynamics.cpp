@@ -0,0 +1,224 @@
+#include "BandDynamics.h"
+
+void BandDynamics::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels <= (juce::uint32)kMaxChannels);
+
+    sampleRate = spec.sampleRate;
+    lookaheadSamples = juce::jmax(1, juce::roundToInt(kLookaheadSeconds * sampleRate));
+    lookaheadRing.assign((size_t)(lookaheadSamples * kMaxVecs), Vec::expand(0.0f));
+
+    reset();
+}
+
+void BandDynamics::reset()
+{
+    for (int v = 0; v < kMaxVecs; ++v)
+    {
+        envelope[v] = Vec::expand(0.0f);
+        gain[v] = Vec::expand(1.0f);
+        gainStep[v] = Vec::expand(0.0f);
+    }
+
+    std::fill(lookaheadRing.begin(), lookaheadRing.end(), Vec::expand(0.0f));
+    ringPos = 0;
+    controlCountdown = 0;
+}
+
+float BandDynamics::computeGain(const BandSettings& settings, float level)
+{
+    if (settings.mode == off)
+        return 1.0f;
+
+    const auto levelDb = juce::Decibels::gainToDecibels(level, -120.0f);
+    auto gainDb = 0.0f;
+
+    if (settings.mode == compress)
+    {
+        const auto over = levelDb - settings.thresholdDb;
+        if (over > 0.0f)
+            gainDb = -over * (1.0f - 1.0f / settings.ratio);
+    }
+    else
+    {
+        const auto under = settings.thresholdDb - levelDb;
+        if (under > 0.0f)
+            gainDb = -juce::jmin(under * (settings.ratio - 1.0f), kMaxExpansionDb);
+    }
+
+    return juce::Decibels::decibelsToGain(gainDb + settings.makeupDb, -120.0f);
+}
+
+void BandDynamics::updateGainRamps(const BandSettings* settings, const bool* processBand, bool stereoLink)
+{
+    alignas(Vec::SIMDRegisterSize) float env[kMaxVecs * kLanes];
+    alignas(Vec::SIMDRegisterSize) float current[kMaxVecs * kLanes];
+    alignas(Vec::SIMDRegisterSize) float step[kMaxVecs * kLanes] = {};
+
+    for (int v = 0; v < kMaxVecs; ++v)
+    {
+        envelope[v].copyToRawArray(env + v * kLanes);
+        gain[v].copyToRawArray(current + v * kLanes);
+    }
+
+    const auto numCh = activeNumChannels;
+    const auto link = stereoLink && numCh == 2;
+
+    for (int lane = 0; lane < activeNumBands * numCh; ++lane)
+    {
+        const auto band = lane / numCh;
+        if (!processBand[band])
+            continue;
+
+        const auto level = link ? juce::jmax(env[band * 2], env[band * 2 + 1]) : env[lane];
+        step[lane] = (computeGain(settings[band], level) - current[lane]) / (float)kControlInterval;
+    }
+
+    for (int v = 0; v < kMaxVecs; ++v)
+        gainStep[v] = Vec::fromRawArray(step + v * kLanes);
+}
+
+void BandDynamics::process(juce::AudioBuffer<float>& bands,
+    const BandSettings* settings,
+    const bool* processBand,
+    int numBands,
+    int numChannels,
+    int numSamples,
+    bool stereoLink,
+    bool lookahead)
+{
+    numBands = juce::jlimit(1, kMaxBands, numBands);
+    numChannels = juce::jlimit(1, kMaxChannels, numChannels);
+
+    jassert(bands.getNumChannels() >= numBands * numChannels);
+    jassert(bands.getNumSamples() >= numSamples);
+
+    if (numBands != activeNumBands || numChannels != activeNumChannels || lookahead != activeLookahead)
+    {
+        activeNumBands = numBands;
+        activeNumChannels = numChannels;
+        activeLookahead = lookahead;
+        reset();
+    }
+
+    const auto numLanes = numBands * numChannels;
+    const auto numVecs = (numLanes + kLanes - 1) / kLanes;
+    const auto stride = numVecs * kLanes;
+    const auto delay = lookahead ? lookaheadSamples : 0;
+
+    // Ballistics per lane. Lanes of bands sitting this block out go back to unity gain
+    alignas(Vec::SIMDRegisterSize) float attackRaw[kMaxVecs * kLanes] = {};
+    alignas(Vec::SIMDRegisterSize) float releaseRaw[kMaxVecs * kLanes] = {};
+    alignas(Vec::SIMDRegisterSize) float env[kMaxVecs * kLanes];
+    alignas(Vec::SIMDRegisterSize) float current[kMaxVecs * kLanes];
+    alignas(Vec::SIMDRegisterSize) float step[kMaxVecs * kLanes];
+
+    for (int v = 0; v < kMaxVecs; ++v)
+    {
+        envelope[v].copyToRawArray(env + v * kLanes);
+        gain[v].copyToRawArray(current + v * kLanes);
+        gainStep[v].copyToRawArray(step + v * kLanes);
+    }
+
+    auto coefficientFor = [this](float ms)
+        {
+            return (float)std::exp(-1.0 / (juce::jmax(0.01, (double)ms) * 0.001 * sampleRate));
+        };
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto band = lane / numChannels;
+
+        if (processBand[band])
+        {
+            attackRaw[lane] = coefficientFor(settings[band].attackMs);
+            releaseRaw[lane] = coefficientFor(settings[band].releaseMs);
+        }
+        else
+        {
+            env[lane] = 0.0f;
+            current[lane] = 1.0f;
+            step[lane] = 0.0f;
+        }
+    }
+
+    Vec attack[kMaxVecs], release[kMaxVecs];
+    for (int v = 0; v < kMaxVecs; ++v)
+    {
+        attack[v] = Vec::fromRawArray(attackRaw + v * kLanes);
+        release[v] = Vec::fromRawArray(releaseRaw + v * kLanes);
+        envelope[v] = Vec::fromRawArray(env + v * kLanes);
+        gain[v] = Vec::fromRawArray(current + v * kLanes);
+        gainStep[v] = Vec::fromRawArray(step + v * kLanes);
+    }
+
+    // Interleaved tile: sample i of lane l lives at [i * stride + l]
+    alignas(Vec::SIMDRegisterSize) float tile[kTileSize * kMaxVecs * kLanes];
+
+    for (int start = 0; start < numSamples; start += kTileSize)
+    {
+        const auto n = juce::jmin(kTileSize, numSamples - start);
+
+        // Skipped bands and padding lanes just run silence
+        std::fill(tile, tile + n * stride, 0.0f);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            if (!processBand[lane / numChannels])
+                continue;
+
+            const auto* src = bands.getReadPointer(lane, start);
+            for (int i = 0; i < n; ++i)
+                tile[i * stride + lane] = src[i];
+        }
+
+        for (int i = 0; i < n;)
+        {
+            if (controlCountdown == 0)
+            {
+                updateGainRamps(settings, processBand, stereoLink);
+                controlCountdown = kControlInterval;
+            }
+
+            const auto run = juce::jmin(controlCountdown, n - i);
+
+            for (int j = i; j < i + run; ++j)
+            {
+                auto* frame = tile + j * stride;
+
+                for (int v = 0; v < numVecs; ++v)
+                {
+                    auto x = Vec::fromRawArray(frame + v * kLanes);
+
+                    // Peak follower: attack coefficient while rising, release while falling
+                    const auto level = Vec::abs(x);
+                    const auto coeff = release[v] + ((attack[v] - release[v]) & Vec::greaterThan(level, envelope[v]));
+                    envelope[v] = level + coeff * (envelope[v] - level);
+
+                    // The detector has seen this sample, the audio path gets the one from delay samples ago
+                    if (delay > 0)
+                        std::swap(x, lookaheadRing[(size_t)(ringPos * kMaxVecs + v)]);
+
+                    gain[v] += gainStep[v];
+                    (x * gain[v]).copyToRawArray(frame + v * kLanes);
+                }
+
+                if (delay > 0 && ++ringPos == delay)
+                    ringPos = 0;
+            }
+
+            i += run;
+            controlCountdown -= run;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            if (!processBand[lane / numChannels])
+                continue;
+
+            auto* dst = bands.getWritePointer(lane, start);
+            for (int i = 0; i < n; ++i)
+                dst[i] = tile[i * stride + lane];
+        }
+    }
+}
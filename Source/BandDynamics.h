@@ -0,0 +1,98 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+
+// Per-band compressor/expander that runs straight on the split bands.
+//
+// Every (band, channel) pair is one lane, and the lanes are packed into SIMD registers so all the
+// envelope followers and gain ramps for all bands run together, on interleaved tiles like the
+// split kernel. The peak envelope follows each sample. The gain computer (the only part that needs
+// log/exp) runs once every kControlInterval samples, and the gain ramps linearly between updates.
+//
+// Stereo link drives both channels of a band from the louder one. Lookahead delays the audio
+// against the detector, so gain reduction lands before a transient rather than on it. It delays
+// every band it processes, so callers have to route all bands through here while it's on.
+class BandDynamics
+{
+public:
+    static constexpr int kMaxBands = BandSplitter::kMaxBands;
+    static constexpr int kMaxChannels = 2;
+
+    enum Mode { off = 0, compress, expand };
+
+    struct BandSettings
+    {
+        int mode = off;
+        float thresholdDb = -18.0f;
+        float ratio = 4.0f;
+        float attackMs = 10.0f;
+        float releaseMs = 150.0f;
+        float makeupDb = 0.0f;
+    };
+
+    BandDynamics() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Delay added while lookahead is on, valid after prepare()
+    int getLookaheadSamples() const noexcept { return lookaheadSamples; }
+
+    // Processes the bands flagged in processBand in place. bands uses BandSplitter's band-major
+    // layout (channel c of band b is channel b * numChannels + c). Bands in mode off just pass
+    // through (delayed, with lookahead on). A change of band count, channel count or lookahead
+    // starts over from unity gain.
+    void process(juce::AudioBuffer<float>& bands,
+        const BandSettings* settings,
+        const bool* processBand,
+        int numBands,
+        int numChannels,
+        int numSamples,
+        bool stereoLink,
+        bool lookahead);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = (int)Vec::SIMDNumElements;
+    static constexpr int kMaxLanes = kMaxBands * kMaxChannels;
+    static constexpr int kMaxVecs = (kMaxLanes + kLanes - 1) / kLanes;
+
+    // Samples per interleaved tile (tile buffers live on the stack)
+    static constexpr int kTileSize = 64;
+
+    // Gain computer update period in samples
+    static constexpr int kControlInterval = 16;
+
+    static constexpr double kLookaheadSeconds = 0.005;
+
+    // Downward expansion never goes further than this
+    static constexpr float kMaxExpansionDb = 60.0f;
+
+    // Static curve: linear gain (makeup included) for a detector level
+    static float computeGain(const BandSettings& settings, float level);
+
+    // Recomputes the gain targets from the envelopes and sets the ramps towards them
+    void updateGainRamps(const BandSettings* settings, const bool* processBand, bool stereoLink);
+
+    double sampleRate = 44100.0;
+    int lookaheadSamples = 0;
+
+    // Layout the states were built for
+    int activeNumBands = 0;
+    int activeNumChannels = 0;
+    bool activeLookahead = false;
+
+    // Per-lane states (lane = band * numChannels + channel)
+    Vec envelope[kMaxVecs];
+    Vec gain[kMaxVecs];
+    Vec gainStep[kMaxVecs];
+
+    // Lookahead delay, interleaved like the tiles: lookaheadSamples rows of kMaxVecs registers
+    std::vector<Vec> lookaheadRing;
+    int ringPos = 0;
+
+    // Samples left until the next gain computer update
+    int controlCountdown = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandDynamics)
+};
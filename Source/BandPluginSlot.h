@@ -37,10 +37,15 @@ public:
     void setPluginName(const juce::String& name) { pluginName = name; updateButtonText(); }
     void setHasPlugin(bool has) { hasPlugin = has; updateButtonText(); }
 
+    // Shown while a plugin loads into the slot in the background (no menu until it's done)
+    void setPending(bool isPending) { pending = isPending; slotButton.setEnabled(!pending); updateButtonText(); }
+
 private:
     void updateButtonText()
     {
-        if (hasPlugin)
+        if (pending)
+            slotButton.setButtonText("Loading...");
+        else if (hasPlugin)
             slotButton.setButtonText(pluginName.isEmpty() ? "Plugin" : pluginName);
         else
             slotButton.setButtonText("-None-");
@@ -123,6 +128,7 @@ private:
     int bandIndex = 0;
 	int slotIndex = 0;
     bool hasPlugin = false;
+    bool pending = false;
     juce::String pluginName;
 
     juce::TextButton slotButton;
@@ -0,0 +1,189 @@
+#include "BandReverb.h"
+
+juce::StringArray BandReverb::getPresetNames()
+{
+    juce::StringArray names;
+    for (const auto& preset : kPresets)
+        names.add(preset.name);
+
+    return names;
+}
+
+void BandReverb::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // Every line can hold the longest preset, so preset changes never allocate
+    auto maxSizeMs = 0.0f;
+    for (const auto& preset : kPresets)
+        maxSizeMs = juce::jmax(maxSizeMs, preset.sizeMs);
+
+    lineCapacity = juce::nextPowerOfTwo((int)std::ceil(maxSizeMs * 0.001 * sampleRate) + 1);
+    pool.assign((size_t)(kNumSlots * kNumLines * lineCapacity), 0.0f);
+
+    for (auto& slot : slots)
+        slot.wet.reset(sampleRate, 0.02);
+
+    reset();
+}
+
+void BandReverb::reset()
+{
+    std::fill(pool.begin(), pool.end(), 0.0f);
+
+    for (auto& slot : slots)
+    {
+        for (auto& state : slot.lowpass)
+            state = Vec::expand(0.0f);
+
+        slot.writePos = 0;
+        slot.preset = -1;
+        slot.activity.reset();
+    }
+}
+
+void BandReverb::loadPreset(Slot& slot, int preset)
+{
+    const auto& p = kPresets[juce::jlimit(0, kNumPresets - 1, preset)];
+
+    alignas(Vec::SIMDRegisterSize) float gains[kNumLines];
+
+    for (int line = 0; line < kNumLines; ++line)
+    {
+        // Odd lengths keep the lines from sharing factors of two
+        const auto length = (int)std::round(p.sizeMs * kLineRatios[line] * 0.001 * sampleRate) | 1;
+        slot.lengths[line] = juce::jlimit(1, lineCapacity - 1, length);
+
+        // -60 dB after decaySeconds, whatever the line length
+        gains[line] = (float)std::pow(0.001, slot.lengths[line] / (p.decaySeconds * sampleRate));
+    }
+
+    for (int v = 0; v < kVecs; ++v)
+        slot.feedback[v] = Vec::fromRawArray(gains + v * kLanes);
+
+    const auto cutoff = juce::jmin((double)p.dampingHz, sampleRate * 0.45);
+    slot.damping = Vec::expand((float)(1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoff / sampleRate)));
+
+    slot.width = p.width;
+    slot.decaySamples = (int)(p.decaySeconds * sampleRate);
+    slot.preset = preset;
+}
+
+bool BandReverb::isActive(int slot, float wetGain) const noexcept
+{
+    return wetGain > 0.0f || slots[slot].wet.getCurrentValue() > 0.0f;
+}
+
+void BandReverb::process(int slotIndex, const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+    int preset, float wetGain, int numSamples, const float* wetOffsets)
+{
+    auto& slot = slots[slotIndex];
+
+    if (preset != slot.preset)
+        loadPreset(slot, preset);
+
+    slot.wet.setTargetValue(wetGain);
+
+    const auto numCh = juce::jmin(2, input.getNumChannels(), output.getNumChannels());
+
+    // Nothing going in and the tail has died away
+    if (!slot.activity.beginBlock(Silence::isSilent(input, 0, numCh, numSamples), numSamples))
+    {
+        slot.wet.skip(numSamples);
+        return;
+    }
+
+    const auto mask = lineCapacity - 1;
+
+    float* lines[kNumLines];
+    for (int line = 0; line < kNumLines; ++line)
+        lines[line] = pool.data() + (size_t)((slotIndex * kNumLines + line) * lineCapacity);
+
+    const auto* inL = input.getReadPointer(0);
+    const auto* inR = input.getReadPointer(numCh - 1);
+    auto* outL = output.getWritePointer(0);
+    auto* outR = numCh > 1 ? output.getWritePointer(1) : nullptr;
+
+    alignas(Vec::SIMDRegisterSize) float taps[kNumLines];
+    alignas(Vec::SIMDRegisterSize) float next[kNumLines];
+    alignas(Vec::SIMDRegisterSize) float inject[kLanes];
+
+    float wetRamp[kTileSize];
+    auto peak = 0.0f;
+
+    for (int start = 0; start < numSamples; start += kTileSize)
+    {
+        const auto n = juce::jmin(kTileSize, numSamples - start);
+        slot.wet.fillRamp(wetRamp, n);
+
+        if (wetOffsets != nullptr)
+        {
+            juce::FloatVectorOperations::add(wetRamp, wetOffsets + start, n);
+            juce::FloatVectorOperations::clip(wetRamp, wetRamp, 0.0f, 1.0f, n);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            const auto pos = slot.writePos;
+
+            for (int line = 0; line < kNumLines; ++line)
+                taps[line] = lines[line][(pos - slot.lengths[line]) & mask];
+
+            // Even lines feed the left output, odd lines the right
+            auto left = 0.0f, right = 0.0f;
+            for (int line = 0; line < kNumLines; line += 2)
+            {
+                left += taps[line];
+                right += taps[line + 1];
+            }
+
+            const auto gain = kOutputGain * wetRamp[i];
+            const auto mid = (left + right) * 0.5f * gain;
+            const auto side = (left - right) * 0.5f * gain * slot.width;
+
+            if (outR != nullptr)
+            {
+                outL[start + i] += mid + side;
+                outR[start + i] += mid - side;
+            }
+            else
+            {
+                outL[start + i] += mid;
+            }
+
+            peak = juce::jmax(peak, std::abs(mid) + std::abs(side));
+
+            // Damping and decay per line, then the Householder mix
+            Vec decayed[kVecs];
+            auto sum = 0.0f;
+
+            for (int v = 0; v < kVecs; ++v)
+            {
+                const auto x = Vec::fromRawArray(taps + v * kLanes);
+                slot.lowpass[v] += slot.damping * (x - slot.lowpass[v]);
+                decayed[v] = slot.lowpass[v] * slot.feedback[v];
+                sum += decayed[v].sum();
+            }
+
+            for (int lane = 0; lane < kLanes; lane += 2)
+            {
+                inject[lane] = inL[start + i];
+                inject[lane + 1] = inR[start + i];
+            }
+
+            const auto reflection = Vec::expand(sum * (2.0f / (float)kNumLines));
+            const auto in = Vec::fromRawArray(inject);
+
+            for (int v = 0; v < kVecs; ++v)
+                (decayed[v] - reflection + in).copyToRawArray(next + v * kLanes);
+
+            for (int line = 0; line < kNumLines; ++line)
+                lines[line][pos] = next[line];
+
+            slot.writePos = (pos + 1) & mask;
+        }
+    }
+
+    // Sleep once the wet output has stayed quiet for the preset's decay time
+    slot.activity.endBlock(peak < Silence::kThreshold, slot.decaySamples, slot.decaySamples, numSamples);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SmoothedGain.h"
+#include "SilenceTracking.h"
+
+// Native reverbs for the pitch-dependent FX, one per reverb slot (low / mid / high band).
+//
+// Each reverb is an 8-line feedback delay network. The delay outputs go through a per-line
+// damping lowpass and decay gain, are mixed by a Householder matrix (x - 2/N * sum(x)) and fed
+// back together with the input. The lines are processed as SIMD registers, and only the delay
+// reads and writes are scalar.
+//
+// All the lines of all slots live in one pool that is allocated in prepare() and sized for the
+// largest preset, so a preset change only moves the read taps. A slot stops processing once its
+// input is silent and its tail has died away.
+class BandReverb
+{
+public:
+    static constexpr int kNumSlots = 3;
+    static constexpr int kNumLines = 8;
+
+    struct Preset
+    {
+        const char* name;
+        float sizeMs;           // longest delay line
+        float decaySeconds;     // RT60
+        float dampingHz;        // feedback lowpass cutoff
+        float width;            // 0 = mono, 1 = full stereo
+    };
+
+    // Order matches the preset combo boxes in the band windows
+    static constexpr Preset kPresets[] = {
+        { "Small Room",   12.0f, 0.5f,  8000.0f, 0.7f },
+        { "Concert Hall", 45.0f, 2.8f,  6000.0f, 1.0f },
+        { "Dark Room",    20.0f, 1.2f,  2000.0f, 0.8f },
+        { "Bright Room",  18.0f, 1.0f, 14000.0f, 0.9f },
+        { "Ambient Room", 40.0f, 4.5f,  5000.0f, 1.0f }
+    };
+
+    static constexpr int kNumPresets = (int)std::size(kPresets);
+
+    static juce::StringArray getPresetNames();
+
+    BandReverb() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Adds the slot's wet signal for numSamples of input into output (up to two channels).
+    // wetGain is a target, the slot ramps to it. wetOffsets (optional, numSamples long) are added
+    // to the ramp per sample, clamped to 0..1
+    void process(int slot, const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output,
+        int preset, float wetGain, int numSamples, const float* wetOffsets = nullptr);
+
+    // False while a slot sits at zero wet gain, so its input doesn't need building
+    bool isActive(int slot, float wetGain) const noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = (int)Vec::SIMDNumElements;
+    static constexpr int kVecs = kNumLines / kLanes;
+
+    static_assert(kNumLines % kLanes == 0 && kLanes % 2 == 0, "Lines must fill whole registers, alternating L/R");
+
+    // Samples per wet gain ramp tile (the ramp lives on the stack)
+    static constexpr int kTileSize = 64;
+
+    // Delay lengths relative to the preset size, spread so the echoes don't line up
+    static constexpr float kLineRatios[kNumLines] = { 0.53f, 0.59f, 0.64f, 0.71f, 0.77f, 0.84f, 0.92f, 1.0f };
+
+    // Scales the four lines summed into each output channel
+    static constexpr float kOutputGain = 0.35f;
+
+    struct Slot
+    {
+        int preset = -1;
+        int lengths[kNumLines] = {};
+        Vec feedback[kVecs];    // per-line decay gain for the preset's RT60
+        Vec lowpass[kVecs];     // damping filter states
+        Vec damping;            // damping one-pole coefficient
+        float width = 1.0f;
+        int decaySamples = 0;
+        int writePos = 0;
+
+        SmoothedGain wet;
+        PluginActivity activity;
+    };
+
+    void loadPreset(Slot& slot, int preset);
+
+    double sampleRate = 44100.0;
+
+    // Per-line capacity (power of two, so positions wrap with a mask)
+    int lineCapacity = 0;
+
+    // kNumSlots * kNumLines lines of lineCapacity samples each
+    std::vector<float> pool;
+
+    Slot slots[kNumSlots];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandReverb)
+};
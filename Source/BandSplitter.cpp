@@ -0,0 +1,309 @@
+#include "BandSplitter.h"
+
+namespace
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    constexpr float kR2 = juce::MathConstants<float>::sqrt2;
+
+    // One TPT state-variable section, run on every lane at once
+    inline void svf(Vec in, Vec& s1, Vec& s2, Vec g, Vec r2PlusG, Vec h, Vec& yL, Vec& yB, Vec& yH)
+    {
+        yH = (in - r2PlusG * s1 - s2) * h;
+
+        yB = g * yH + s1;
+        s1 = g * yH + yB;
+
+        yL = g * yB + s2;
+        s2 = g * yB + yL;
+    }
+}
+
+BandSplitter::BandSplitter()
+{
+    for (auto& target : targetHz)
+        target.store(1000.0f, std::memory_order_relaxed);
+}
+
+void BandSplitter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // One lane group per kLanes channels
+    const auto numGroups = ((int)spec.numChannels + kLanes - 1) / kLanes;
+    laneGroups.resize((size_t)juce::jmax(1, numGroups));
+
+    for (auto& ramp : crossoverHz)
+        ramp.reset(sampleRate, kRampSeconds);
+
+    snapToTargets();
+
+    reset();
+}
+
+void BandSplitter::reset()
+{
+    for (auto& group : laneGroups)
+    {
+        for (int s = 0; s < kMaxSections; ++s)
+        {
+            group.s1[s] = Vec::expand(0.0f);
+            group.s2[s] = Vec::expand(0.0f);
+        }
+    }
+
+    statesSettled = true;
+}
+
+BandSplitter::SplitCoeffs BandSplitter::makeCoeffs(float cutoffHz) const
+{
+    jassert(cutoffHz > 0.0f && cutoffHz < (float)(sampleRate * 0.5));
+
+    SplitCoeffs c;
+    c.g = (float)std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate);
+    c.h = 1.0f / (1.0f + kR2 * c.g + c.g * c.g);
+    return c;
+}
+
+void BandSplitter::setTargetCrossovers(const float* crossovers, int numCrossovers)
+{
+    jassert(numCrossovers <= kMaxCrossovers);
+
+    for (int k = 0; k < juce::jmin(numCrossovers, kMaxCrossovers); ++k)
+        targetHz[k].store(crossovers[k], std::memory_order_relaxed);
+}
+
+void BandSplitter::snapToTargets()
+{
+    for (int k = 0; k < kMaxCrossovers; ++k)
+    {
+        crossoverHz[k].setCurrentAndTargetValue(targetHz[k].load(std::memory_order_relaxed));
+        crossoverCoeffs[k] = makeCoeffs(crossoverHz[k].getCurrentValue());
+    }
+}
+
+void BandSplitter::advanceCrossovers(int numSamples)
+{
+    // The compensation allpasses share their split's coefficients, so they can't drift apart
+    for (int k = 0; k < activeNumBands - 1; ++k)
+        if (crossoverHz[k].isSmoothing())
+            crossoverCoeffs[k] = makeCoeffs(crossoverHz[k].skip(numSamples));
+}
+
+BandSplitter::TileKernel BandSplitter::getTileKernel(int numBands)
+{
+    static constexpr TileKernel kernels[] = {
+        &BandSplitter::processTile<2>,
+        &BandSplitter::processTile<3>,
+        &BandSplitter::processTile<4>,
+        &BandSplitter::processTile<5>,
+        &BandSplitter::processTile<6>,
+        &BandSplitter::processTile<7>,
+        &BandSplitter::processTile<8>
+    };
+
+    static_assert(std::size(kernels) == kMaxBands - kMinBands + 1, "One kernel per supported band count");
+    return kernels[juce::jlimit(kMinBands, kMaxBands, numBands) - kMinBands];
+}
+
+void BandSplitter::process(const juce::AudioBuffer<float>& input,
+    juce::AudioBuffer<float>& output,
+    juce::AudioBuffer<float>& bands,
+    const BandMix& mix,
+    int numBands,
+    int numSamples)
+{
+    numBands = juce::jlimit(kMinBands, kMaxBands, numBands);
+    const auto numCh = input.getNumChannels();
+
+    jassert(output.getNumChannels() >= numCh && output.getNumSamples() >= numSamples);
+    jassert(bands.getNumChannels() >= numBands * numCh);
+    jassert(bands.getNumSamples() >= numSamples);
+    jassert((size_t)((numCh + kLanes - 1) / kLanes) <= laneGroups.size());
+
+    // The section layout depends on the band count, so old states mean nothing after a change
+    if (numBands != activeNumBands)
+    {
+        activeNumBands = numBands;
+        snapToTargets();
+        reset();
+    }
+
+    // Interleaved tiles: sample i of lane c lives at [i * kLanes + c]
+    alignas(Vec::SIMDRegisterSize) float inTile[kTileSize * kLanes];
+    alignas(Vec::SIMDRegisterSize) float mixTile[kTileSize * kLanes];
+    alignas(Vec::SIMDRegisterSize) float bandTiles[kMaxBands][kTileSize * kLanes];
+
+    float* bandOut[kMaxBands];
+    for (int b = 0; b < kMaxBands; ++b)
+        bandOut[b] = bandTiles[b];
+
+    // Pick up whatever targets were published since the last block
+    for (int k = 0; k < numBands - 1; ++k)
+        crossoverHz[k].setTargetValue(targetHz[k].load(std::memory_order_relaxed));
+
+    // Nothing in the chain is ringing, so digital silence in means digital silence out
+    if (statesSettled && Silence::isDigitalSilence(input, 0, numCh, numSamples))
+    {
+        advanceCrossovers(numSamples);
+
+        for (int c = 0; c < numCh; ++c)
+            output.clear(c, 0, numSamples);
+
+        for (int b = 0; b < numBands; ++b)
+            if (mix.writeBand[b])
+                for (int c = 0; c < numCh; ++c)
+                    bands.clear(b * numCh + c, 0, numSamples);
+
+        return;
+    }
+
+    const auto kernel = getTileKernel(numBands);
+    const auto numGroups = juce::jmin((int)laneGroups.size(), (numCh + kLanes - 1) / kLanes);
+
+    for (int start = 0; start < numSamples; start += kTileSize)
+    {
+        const auto n = juce::jmin(kTileSize, numSamples - start);
+
+        // Coefficients step once per tile while ramping
+        advanceCrossovers(n);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const auto firstCh = group * kLanes;
+            const auto groupCh = juce::jmin(kLanes, numCh - firstCh);
+
+            for (int c = 0; c < groupCh; ++c)
+            {
+                const auto* src = input.getReadPointer(firstCh + c, start);
+                for (int i = 0; i < n; ++i)
+                    inTile[i * kLanes + c] = src[i];
+            }
+
+            // Unused lanes just run silence through their (never read) states
+            for (int c = groupCh; c < kLanes; ++c)
+                for (int i = 0; i < n; ++i)
+                    inTile[i * kLanes + c] = 0.0f;
+
+            (this->*kernel)(laneGroups[(size_t)group], inTile, mixTile, bandOut, mix, start, n);
+
+            // The input tile is already consumed, so this is safe when output aliases input
+            for (int c = 0; c < groupCh; ++c)
+            {
+                auto* dst = output.getWritePointer(firstCh + c, start);
+                for (int i = 0; i < n; ++i)
+                    dst[i] = mixTile[i * kLanes + c];
+            }
+
+            for (int b = 0; b < numBands; ++b)
+            {
+                if (!mix.writeBand[b])
+                    continue;
+
+                for (int c = 0; c < groupCh; ++c)
+                {
+                    auto* dst = bands.getWritePointer(b * numCh + firstCh + c, start);
+                    const auto* tile = bandTiles[b];
+
+                    for (int i = 0; i < n; ++i)
+                        dst[i] = tile[i * kLanes + c];
+                }
+            }
+        }
+    }
+
+    // Flush decayed states so silence stays exactly zero, and note when the whole chain has settled
+    alignas(Vec::SIMDRegisterSize) float raw[kLanes];
+    statesSettled = true;
+
+    for (auto& lanes : laneGroups)
+    {
+        for (int s = 0; s < numSectionsFor(numBands); ++s)
+        {
+            for (auto* state : { &lanes.s1[s], &lanes.s2[s] })
+            {
+                state->copyToRawArray(raw);
+                for (auto& v : raw)
+                {
+                    JUCE_SNAP_TO_ZERO(v);
+                    statesSettled = statesSettled && v == 0.0f;
+                }
+                *state = Vec::fromRawArray(raw);
+            }
+        }
+    }
+}
+
+template <int NumBands>
+void BandSplitter::processTile(LaneGroup& group, const float* in, float* mixOut, float* const* bandOut,
+    const BandMix& mix, int tileStart, int numSamples) const
+{
+    constexpr int numCrossovers = NumBands - 1;
+    constexpr int numSections = numSectionsFor(NumBands);
+
+    // Gain ramps offset to this tile (nullptr = steady gain)
+    const float* ramps[NumBands];
+    for (int b = 0; b < NumBands; ++b)
+        ramps[b] = mix.gainRamp[b] != nullptr ? mix.gainRamp[b] + tileStart : nullptr;
+
+    auto gainAt = [&](int b, int i) { return Vec::expand(ramps[b] != nullptr ? ramps[b][i] : mix.gain[b]); };
+
+    Vec g[numCrossovers], r2g[numCrossovers], h[numCrossovers];
+    for (int k = 0; k < numCrossovers; ++k)
+    {
+        g[k] = Vec::expand(crossoverCoeffs[k].g);
+        r2g[k] = Vec::expand(kR2 + crossoverCoeffs[k].g);
+        h[k] = Vec::expand(crossoverCoeffs[k].h);
+    }
+
+    // Keep the states in locals for the whole tile
+    Vec a1[numSections], a2[numSections];
+    for (int s = 0; s < numSections; ++s) { a1[s] = group.s1[s]; a2[s] = group.s2[s]; }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto upper = Vec::fromRawArray(in + i * kLanes);
+        auto sum = Vec::expand(0.0f);
+        Vec yL, yB, yH, yL2, yB2, yH2;
+
+        // Compensation allpasses follow the split sections
+        int allpass = 2 * numCrossovers;
+
+        for (int k = 0; k < numCrossovers; ++k)
+        {
+            // Split k: LR4 low = LP(LP(x)), LR4 high = AP(x) - low
+            svf(upper, a1[2 * k], a2[2 * k], g[k], r2g[k], h[k], yL, yB, yH);
+            svf(yL, a1[2 * k + 1], a2[2 * k + 1], g[k], r2g[k], h[k], yL2, yB2, yH2);
+
+            auto band = yL2;
+            upper = yL - yB * kR2 + yH - yL2;
+
+            // Catch the peeled band up with the splits still to come on the upper branch
+            for (int m = k + 1; m < numCrossovers; ++m, ++allpass)
+            {
+                svf(band, a1[allpass], a2[allpass], g[m], r2g[m], h[m], yL, yB, yH);
+                band = yL - yB * kR2 + yH;
+            }
+
+            band = band * gainAt(k, i);
+
+            if (!mix.excludeFromMix[k])
+                sum += band;
+
+            if (mix.writeBand[k])
+                band.copyToRawArray(bandOut[k] + i * kLanes);
+        }
+
+        upper = upper * gainAt(numCrossovers, i);
+
+        if (!mix.excludeFromMix[numCrossovers])
+            sum += upper;
+
+        if (mix.writeBand[numCrossovers])
+            upper.copyToRawArray(bandOut[numCrossovers] + i * kLanes);
+
+        sum.copyToRawArray(mixOut + i * kLanes);
+    }
+
+    for (int s = 0; s < numSections; ++s) { group.s1[s] = a1[s]; group.s2[s] = a2[s]; }
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SilenceTracking.h"
+
+// N-band (2..8) Linkwitz-Riley (LR4) split chain.
+//
+//   input --LR4 @ c0--+--low---> allpass @ c1..cN-2 ------------------> band 0
+//                     +--upper-> LR4 @ c1--+--low--> allpass @ c2..cN-2 -> band 1
+//                                          +--upper-> ...              -> band N-1
+//
+// Each split peels the lowest band off the remaining upper branch. The allpasses on a peeled
+// band give it the phase shift the upper branch picks up from the splits above it, so all
+// bands sum back to a flat (allpassed) copy of the input. Band k is peeled off by one LR4 split
+// (two sections) and then needs an allpass for each of the N-2-k splits above it, so the chain is
+// 2(N-1) + (N-1)(N-2)/2 sections in all: quadratic in the band count, 35 sections at 8 bands.
+//
+// Every section is a TPT state-variable filter. The states for all sections are kept in SoA
+// form with one SIMD lane per channel, and the per-sample kernel is specialised at compile time
+// for each band count so the whole chain unrolls into straight-line SIMD code.
+//
+// The band gains and the final mix are fused into the same kernel: each band is scaled and
+// summed into the output while it is still in registers. Only bands that something else needs
+// (hosted plugin sends) get written out to memory.
+//
+// Once the filter states have decayed to exactly zero, a digitally silent input block (zeros or
+// denormals) can only produce silence, so the whole chain is skipped until signal returns.
+class BandSplitter
+{
+public:
+    static constexpr int kMinBands = 2;
+    static constexpr int kMaxBands = 8;
+    static constexpr int kMaxCrossovers = kMaxBands - 1;
+
+    // Per-block description of what happens to each band after the split
+    struct BandMix
+    {
+        // Band gain: a per-sample ramp (numSamples values) while it is moving, otherwise constant
+        float gain[kMaxBands] = {};
+        const float* gainRamp[kMaxBands] = {};
+
+        // Bands whose gained signal is also written to the bands buffer
+        bool writeBand[kMaxBands] = {};
+
+        // Bands left out of the sum (written out instead, for the caller to process and mix in itself)
+        bool excludeFromMix[kMaxBands] = {};
+    };
+
+    BandSplitter();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Ascending crossover frequencies in Hz (numCrossovers = band count - 1).
+    // Lock-free, callable from any thread: only the targets are published here, the audio
+    // thread picks them up in process() and ramps towards them without allocating.
+    void setTargetCrossovers(const float* crossoverHz, int numCrossovers);
+
+    // Jumps straight to the current targets (no ramp), call from prepare/reset paths only
+    void snapToTargets();
+
+    // Splits numSamples of input into numBands bands, applies the band gains and writes the sum
+    // of the gained bands to output (which may be the input buffer).
+    // bands holds the bands back to back: channel c of band b is channel (b * numInputChannels + c),
+    // and must have at least numBands * input.getNumChannels() channels and numSamples samples.
+    // Only the bands flagged in mix.writeBand are written there.
+    // A change of band count restarts the chain from silence. Digitally silent input into fully
+    // decayed filters just clears the outputs.
+    void process(const juce::AudioBuffer<float>& input,
+        juce::AudioBuffer<float>& output,
+        juce::AudioBuffer<float>& bands,
+        const BandMix& mix,
+        int numBands,
+        int numSamples);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = (int)Vec::SIMDNumElements;
+
+    // Samples per interleaved tile (tile buffers live on the stack).
+    // Coefficients are recomputed once per tile while a crossover is ramping.
+    static constexpr int kTileSize = 64;
+
+    // Crossover ramp time when a target changes
+    static constexpr double kRampSeconds = 0.05;
+
+    // SVF sections for a given band count: two per split (N-1 splits), then the compensation
+    // allpasses, N-2 for band 0 down to none for the top two bands. 35 at 8 bands
+    static constexpr int numSectionsFor(int numBands)
+    {
+        return 2 * (numBands - 1) + (numBands - 1) * (numBands - 2) / 2;
+    }
+
+    // numSectionsFor(kMaxBands), spelled out since the class isn't complete here
+    static constexpr int kMaxSections = 2 * kMaxCrossovers + kMaxCrossovers * (kMaxCrossovers - 1) / 2;
+
+    // Integrator states for one group of kLanes channels
+    struct LaneGroup
+    {
+        Vec s1[kMaxSections];
+        Vec s2[kMaxSections];
+    };
+
+    // TPT coefficients for one crossover frequency
+    struct SplitCoeffs
+    {
+        float g = 0.0f;     // tan(pi * fc / fs)
+        float h = 1.0f;     // 1 / (1 + sqrt2 * g + g * g)
+    };
+
+    SplitCoeffs makeCoeffs(float cutoffHz) const;
+
+    // Advances the crossover ramps by numSamples and refreshes the coefficients if needed (audio thread)
+    void advanceCrossovers(int numSamples);
+
+    // Interleaved tiles in and out. mixOut gets the gained sum, bandOut[b] the gained band b
+    // (flagged bands only). Gain ramps are read from tileStart onwards
+    template <int NumBands>
+    void processTile(LaneGroup& group, const float* in, float* mixOut, float* const* bandOut,
+        const BandMix& mix, int tileStart, int numSamples) const;
+
+    using TileKernel = void (BandSplitter::*)(LaneGroup&, const float*, float*, float* const*, const BandMix&, int, int) const;
+    static TileKernel getTileKernel(int numBands);
+
+    double sampleRate = 44100.0;
+    int activeNumBands = 3;
+    SplitCoeffs crossoverCoeffs[kMaxCrossovers];
+
+    // Mailbox written by any thread, read by the audio thread
+    std::atomic<float> targetHz[kMaxCrossovers];
+
+    // Audio-thread ramps (log-domain, so a sweep sounds even across the spectrum)
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> crossoverHz[kMaxCrossovers];
+
+    std::vector<LaneGroup> laneGroups;
+
+    // True while every active filter state is exactly zero (set by reset and the denormal flush)
+    bool statesSettled = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BandSplitter)
+};
@@ -0,0 +1,90 @@
+#include "BandSplitter.h"
+
+// The bands of every band count have to sum back to the input through one LR4 allpass per crossover
+// (a second-order allpass at Q = 1/sqrt2), both in the fused mix and summed from the written bands
+class BandSplitterTests : public juce::UnitTest
+{
+public:
+    BandSplitterTests() : juce::UnitTest("BandSplitter", "XPulse") {}
+
+    void runTest() override
+    {
+        for (int numBands = BandSplitter::kMinBands; numBands <= BandSplitter::kMaxBands; ++numBands)
+        {
+            beginTest(juce::String(numBands) + " bands null against the allpassed input");
+
+            // Crossovers spread evenly in log frequency between 50 Hz and 16 kHz
+            float hz[BandSplitter::kMaxCrossovers] = {};
+            for (int k = 0; k < numBands - 1; ++k)
+                hz[k] = (float)(50.0 * std::pow(320.0, (double)(k + 1) / numBands));
+
+            BandSplitter splitter;
+            splitter.setTargetCrossovers(hz, numBands - 1);
+            splitter.prepare({ kSampleRate, (juce::uint32)kNumSamples, (juce::uint32)kNumChannels });
+
+            // An impulse per channel, the second one later and quieter so the lanes differ
+            juce::AudioBuffer<float> input(kNumChannels, kNumSamples);
+            input.clear();
+            input.setSample(0, 0, 1.0f);
+            input.setSample(1, 37, 0.5f);
+
+            juce::AudioBuffer<float> output(kNumChannels, kNumSamples);
+            juce::AudioBuffer<float> bands(BandSplitter::kMaxBands * kNumChannels, kNumSamples);
+
+            BandSplitter::BandMix mix;
+            for (int b = 0; b < numBands; ++b)
+            {
+                mix.gain[b] = 1.0f;
+                mix.writeBand[b] = true;
+            }
+
+            splitter.process(input, output, bands, mix, numBands, kNumSamples);
+
+            juce::AudioBuffer<float> expected;
+            expected.makeCopyOf(input);
+
+            for (int ch = 0; ch < kNumChannels; ++ch)
+            {
+                auto* samples = expected.getWritePointer(ch);
+
+                for (int k = 0; k < numBands - 1; ++k)
+                {
+                    juce::dsp::IIR::Filter<float> allpass(juce::dsp::IIR::Coefficients<float>::makeAllPass(kSampleRate, hz[k],
+                        1.0f / juce::MathConstants<float>::sqrt2));
+
+                    for (int i = 0; i < kNumSamples; ++i)
+                        samples[i] = allpass.processSample(samples[i]);
+                }
+            }
+
+            float mixError = 0.0f;
+            float bandsError = 0.0f;
+
+            for (int ch = 0; ch < kNumChannels; ++ch)
+            {
+                for (int i = 0; i < kNumSamples; ++i)
+                {
+                    float sum = 0.0f;
+                    for (int b = 0; b < numBands; ++b)
+                        sum += bands.getSample(b * kNumChannels + ch, i);
+
+                    mixError = juce::jmax(mixError, std::abs(output.getSample(ch, i) - expected.getSample(ch, i)));
+                    bandsError = juce::jmax(bandsError, std::abs(sum - expected.getSample(ch, i)));
+                }
+            }
+
+            expectLessThan(mixError, kTolerance, "mixed output");
+            expectLessThan(bandsError, kTolerance, "sum of the written bands");
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kNumChannels = 2;
+    static constexpr int kNumSamples = 8192;
+
+    // Single precision SIMD sections against a float reference, about -80 dBFS on a unit impulse
+    static constexpr float kTolerance = 1.0e-4f;
+};
+
+static BandSplitterTests bandSplitterTests;
@@ -0,0 +1,26 @@
+#include "BlockEngine.h"
+
+void BlockEngine::prepare(int numChannels, int hostBlockSize)
+{
+    hostChunkSize = juce::jmax(1, hostBlockSize);
+
+    for (auto& fifo : fifos)
+        fifo.setSize(numChannels, kFixedBlockSize);
+
+    reset();
+}
+
+void BlockEngine::reset()
+{
+    for (auto& fifo : fifos)
+        fifo.clear();
+
+    inputFifo = 0;
+    fifoPos = 0;
+}
+
+juce::AudioBuffer<float> BlockEngine::makeView(juce::AudioBuffer<float>& source, int numChannels, int start, int numSamples)
+{
+    // Refers to the source's memory (channel pointers live in the buffer's preallocated space)
+    return juce::AudioBuffer<float>(source.getArrayOfWritePointers(), numChannels, start, numSamples);
+}
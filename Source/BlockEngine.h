@@ -0,0 +1,99 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Feeds the DSP chain blocks of a predictable size, whatever the host sends.
+//
+//   hostBlocks  - host blocks are passed straight through, but sliced so no chunk is ever longer
+//                 than the size prepared for (hosts may exceed samplesPerBlock). No latency.
+//   fixedBlocks - host audio is accumulated into fixed kFixedBlockSize chunks, so the DSP and the
+//                 hosted plugins always see the same block size, even for tiny or irregular host
+//                 blocks. Adds kFixedBlockSize samples of latency.
+//
+// Chunks are handed to the callback as non-owning views, so nothing is allocated per block.
+class BlockEngine
+{
+public:
+    enum Mode { hostBlocks = 0, fixedBlocks };
+
+    // Internal chunk size in fixedBlocks mode
+    static constexpr int kFixedBlockSize = 256;
+
+    BlockEngine() = default;
+
+    // Sizes the FIFOs once. hostBlockSize is the host's samplesPerBlock
+    void prepare(int numChannels, int hostBlockSize);
+    void reset();
+
+    // Largest chunk the callback will ever see in either mode (size DSP buffers and hosted plugins to this)
+    int getMaxChunkSize() const noexcept { return juce::jmax(hostChunkSize, (int)kFixedBlockSize); }
+
+    int getLatencySamples(Mode mode) const noexcept { return mode == fixedBlocks ? kFixedBlockSize : 0; }
+
+    // Size of a full chunk in the given mode (host chunks can come shorter)
+    int getChunkSize(Mode mode) const noexcept { return mode == fixedBlocks ? (int)kFixedBlockSize : hostChunkSize; }
+
+    // Runs processChunk(juce::AudioBuffer<float>&) over the buffer in place. Switching mode starts
+    // the FIFOs over from silence
+    template <typename ChunkCallback>
+    void process(juce::AudioBuffer<float>& buffer, Mode mode, ChunkCallback&& processChunk)
+    {
+        if (mode != activeMode)
+        {
+            activeMode = mode;
+            reset();
+        }
+
+        const auto numCh = juce::jmin(buffer.getNumChannels(), fifos[0].getNumChannels());
+        const auto numSamples = buffer.getNumSamples();
+
+        if (mode == hostBlocks)
+        {
+            for (int start = 0; start < numSamples; start += hostChunkSize)
+            {
+                auto chunk = makeView(buffer, numCh, start, juce::jmin(hostChunkSize, numSamples - start));
+                processChunk(chunk);
+            }
+
+            return;
+        }
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto n = juce::jmin(numSamples - start, kFixedBlockSize - fifoPos);
+            auto& input = fifos[inputFifo];
+            const auto& output = fifos[1 - inputFifo];
+
+            // Host in -> input FIFO, the previous (already processed) chunk -> host out
+            for (int ch = 0; ch < numCh; ++ch)
+            {
+                input.copyFrom(ch, fifoPos, buffer, ch, start, n);
+                buffer.copyFrom(ch, start, output, ch, fifoPos, n);
+            }
+
+            fifoPos += n;
+            start += n;
+
+            if (fifoPos == kFixedBlockSize)
+            {
+                auto chunk = makeView(input, numCh, 0, kFixedBlockSize);
+                processChunk(chunk);
+
+                inputFifo = 1 - inputFifo;
+                fifoPos = 0;
+            }
+        }
+    }
+
+private:
+    static juce::AudioBuffer<float> makeView(juce::AudioBuffer<float>& source, int numChannels, int start, int numSamples);
+
+    int hostChunkSize = kFixedBlockSize;  // slice length in hostBlocks mode
+    Mode activeMode = hostBlocks;
+
+    // Ping-pong chunks: one fills from the host while the other (processed) one drains to it
+    juce::AudioBuffer<float> fifos[2];
+    int inputFifo = 0;
+    int fifoPos = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockEngine)
+};
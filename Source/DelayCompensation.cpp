@@ -0,0 +1,112 @@
+#include "DelayCompensation.h"
+
+void DelayCompensation::prepare(int numChannels, int numRoutes, int maxBlockSize, double sampleRate)
+{
+    maxDelay = (int)std::ceil(sampleRate * kMaxSeconds);
+
+    // Room for a whole block on top of the delay, the block is written before it is read back
+    const auto ringSize = maxDelay + juce::jmax(1, maxBlockSize);
+
+    routes.resize((size_t)numRoutes);
+    for (auto& line : routes)
+        line.ring.setSize(numChannels, ringSize);
+
+    dry.ring.setSize(numChannels, ringSize);
+    scratch.setSize(numChannels, juce::jmax(1, maxBlockSize));
+
+    reset();
+}
+
+void DelayCompensation::reset()
+{
+    auto clear = [](Line& line)
+        {
+            line.ring.clear();
+            line.writePos = 0;
+            line.delay = 0;
+            line.source = 0;
+        };
+
+    for (auto& line : routes)
+        clear(line);
+
+    clear(dry);
+}
+
+void DelayCompensation::processDry(juce::AudioBuffer<float>& buffer, int numSamples, int delaySamples)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), dry.ring.getNumChannels());
+    dry.process(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(), numChannels, numSamples, delaySamples);
+}
+
+const float* const* DelayCompensation::processReturn(int route, juce::uint32 source, const float* const* input,
+    int numChannels, int numSamples, int delaySamples)
+{
+    jassert((size_t)route < routes.size());
+    auto& line = routes[(size_t)route];
+
+    if (line.source != source)
+    {
+        line.ring.clear();
+        line.source = source;
+    }
+
+    numChannels = juce::jmin(numChannels, scratch.getNumChannels());
+
+    if (input == nullptr)
+    {
+        scratch.clear(0, numSamples);
+        input = scratch.getArrayOfReadPointers();
+    }
+
+    line.process(input, scratch.getArrayOfWritePointers(), numChannels, numSamples, delaySamples);
+    return scratch.getArrayOfReadPointers();
+}
+
+void DelayCompensation::processInPlace(int route, float* const* channels, int numChannels, int numSamples, int delaySamples)
+{
+    jassert((size_t)route < routes.size());
+    auto& line = routes[(size_t)route];
+
+    line.process(channels, channels, juce::jmin(numChannels, line.ring.getNumChannels()), numSamples, delaySamples);
+}
+
+void DelayCompensation::Line::process(const float* const* input, float* const* output, int numChannels, int numSamples, int delaySamples)
+{
+    const auto size = ring.getNumSamples();
+    delaySamples = juce::jlimit(0, size - numSamples, delaySamples);
+
+    if (delaySamples != delay)
+    {
+        ring.clear();
+        delay = delaySamples;
+    }
+
+    // Nothing to hold back: the ring stays silent until a delay is set
+    if (delay == 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (output[ch] != input[ch])
+                juce::FloatVectorOperations::copy(output[ch], input[ch], numSamples);
+
+        return;
+    }
+
+    const auto readPos = (writePos - delay + size) % size;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* samples = ring.getWritePointer(ch);
+
+        // Write the block first, then read back delay samples behind it (wrapping around the ring)
+        const auto first = juce::jmin(numSamples, size - writePos);
+        juce::FloatVectorOperations::copy(samples + writePos, input[ch], first);
+        juce::FloatVectorOperations::copy(samples, input[ch] + first, numSamples - first);
+
+        const auto firstRead = juce::jmin(numSamples, size - readPos);
+        juce::FloatVectorOperations::copy(output[ch], samples + readPos, firstRead);
+        juce::FloatVectorOperations::copy(output[ch] + firstRead, samples, numSamples - firstRead);
+    }
+
+    writePos = (writePos + numSamples) % size;
+}
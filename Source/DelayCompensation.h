@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Plugin delay compensation for the hosted plugins.
+//
+// Every route (a band/slot return, or a band behind an insert chain) has its own delay line, and the
+// dry signal (the mix the routes are added to) has one more. Compensated to the slowest route, the dry
+// signal is delayed by its latency and each route by the difference between it and its own latency,
+// so everything lines up again at the output.
+//
+// Lines are allocated once in prepare() for kMaxSeconds; longer latencies are clamped. A line starts
+// over from silence whenever its delay changes or its route starts carrying another instance.
+class DelayCompensation
+{
+public:
+    // Longest latency that gets compensated
+    static constexpr double kMaxSeconds = 0.5;
+
+    DelayCompensation() = default;
+
+    void prepare(int numChannels, int numRoutes, int maxBlockSize, double sampleRate);
+    void reset();
+
+    int getMaxDelay() const noexcept { return maxDelay; }
+
+    // Delays the first numSamples of buffer in place
+    void processDry(juce::AudioBuffer<float>& buffer, int numSamples, int delaySamples);
+
+    // Pushes one route's return through its line and returns the delayed channels (valid until the
+    // next call). A null input feeds silence, so a sleeping instance's line keeps moving
+    const float* const* processReturn(int route, juce::uint32 source, const float* const* input,
+        int numChannels, int numSamples, int delaySamples);
+
+    // Delays one route's channels in place
+    void processInPlace(int route, float* const* channels, int numChannels, int numSamples, int delaySamples);
+
+    // Instance a route's line carries (0 before its first return)
+    juce::uint32 getSource(int route) const noexcept { return routes[(size_t)route].source; }
+
+    // Lets a route's line start over from silence with whatever it carries next
+    void forget(int route) noexcept { routes[(size_t)route].source = 0; }
+
+private:
+    struct Line
+    {
+        juce::AudioBuffer<float> ring;
+        int writePos = 0;
+        int delay = 0;
+        juce::uint32 source = 0;
+
+        // In and out may be the same channels
+        void process(const float* const* input, float* const* output, int numChannels, int numSamples, int delaySamples);
+    };
+
+    std::vector<Line> routes;
+    Line dry;
+
+    // Delayed returns are handed out from here
+    juce::AudioBuffer<float> scratch;
+
+    int maxDelay = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayCompensation)
+};
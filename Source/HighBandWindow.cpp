@@ -4,7 +4,26 @@
 HighBandWindow::HighBandWindow(XPulseAudioProcessor &processorRef, juce::AudioProcessorValueTreeState& apvts)
 	: processorRef(processorRef), apvtsRef(apvts)
 {
-	
+	// Add Sliders
+	addAndMakeVisible(highBandGainSlider);
+    addAndMakeVisible(highBandReverbSlider);
+
+	// Add ComboBox
+	addAndMakeVisible(highReverbBox);
+
+	// Attach components to the APVTS parameter
+    highBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "highGain", highBandGainSlider);
+    highBandReverbAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "highReverbMaster", highBandReverbSlider);
+
+	// Reverb presets come from the parameter (so they match the processor's preset table) and have
+	// to be in the box before the attachment selects the current one
+	if (auto* presetParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("highReverbPreset")))
+		highReverbBox.addItemList(presetParam->choices, 1);
+
+	// Attach ComboBox to the APVTS parameter
+	highReverbBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "highReverbPreset", highReverbBox);
+
+    setSize(400, 200);
 }
 
 HighBandWindow::~HighBandWindow() {}
@@ -17,5 +36,8 @@ void HighBandWindow::paint(juce::Graphics& g)
 
 void HighBandWindow::resized()
 {
-   
+    // Layout child components here
+	highBandGainSlider.setBounds(10, 10, 200, 30);
+    highBandReverbSlider.setBounds(10, 30, 200, 30);
+	highReverbBox.setBounds(220, 30, 150, 30);
 }
@@ -0,0 +1,37 @@
+#pragma once
+#include <JuceHeader.h>
+
+//Hosted Plugin Window Class
+class HostedPluginWindow : public juce::DocumentWindow
+{
+public:
+	HostedPluginWindow(const juce::String& title,
+		std::unique_ptr<juce::AudioProcessorEditor> editor,
+		std::function<void()> onCloseFn)
+		: juce::DocumentWindow(title,
+			juce::Colours::darkgrey,
+			juce::DocumentWindow::closeButton),
+		onClose(std::move(onCloseFn))
+	{
+		setUsingNativeTitleBar(true);
+		setResizable(true, true);
+
+		// Window owns the editor component
+		setContentOwned(editor.release(), true);
+
+		centreAroundComponent(juce::Desktop::getInstance().getMainMouseSource().getComponentUnderMouse(), getWidth(), getHeight());
+		setVisible(true);
+		toFront(true);
+	}
+
+	void closeButtonPressed() override
+	{
+		// Don't delete ourselves directly inside the close event.
+		// Ask the owner to reset the unique_ptr on the message thread.
+		auto cb = onClose;
+		juce::MessageManager::callAsync([cb]() { if (cb) cb(); });
+	}
+
+private:
+	std::function<void()> onClose;
+};
@@ -0,0 +1,187 @@
+#include "InsertChainWindow.h"
+#include "HostProcessor.h"
+#include "HostedPluginWindow.h"
+
+//One band's insert slots, reading and writing the chain straight from the processor
+class InsertChainWindow::Content : public juce::Component
+{
+public:
+    Content(XPulseAudioProcessor& processorRef, int bandToUse)
+        : audioProcessor(processorRef), band(bandToUse)
+    {
+        lengthLabel.setText("Chain Length", juce::dontSendNotification);
+        addAndMakeVisible(lengthLabel);
+
+        lengthSlider.setSliderStyle(juce::Slider::IncDecButtons);
+        lengthSlider.setRange(0.0, (double)XPulseAudioProcessor::kMaxInserts, 1.0);
+        lengthSlider.setValue(audioProcessor.getBandInsertLength(band), juce::dontSendNotification);
+        lengthSlider.onValueChange = [this]()
+            {
+                audioProcessor.setBandInsertLength(band, (int)lengthSlider.getValue());
+                updateSlots();
+            };
+        addAndMakeVisible(lengthSlider);
+
+        for (int position = 0; position < XPulseAudioProcessor::kMaxInserts; ++position)
+        {
+            auto& slot = slots[position];
+            slot.setBandIndex(band);
+            slot.setSlotIndex(position);
+            addAndMakeVisible(slot);
+
+            slot.onRequestRebuildMenuList = [this, &slot](int /*band*/, int /*position*/)
+                {
+                    juce::Array<juce::PluginDescription> descs;
+                    audioProcessor.getHostProcessor().getKnownPluginTypesCopy(descs);
+                    slot.setPluginList(descs);
+                };
+
+            slot.onAddReplace = [this](int /*band*/, int position, const juce::PluginDescription& desc)
+                {
+                    addInsert(position, desc);
+                };
+
+            slot.onRemove = [this](int /*band*/, int position)
+                {
+                    removeInsert(position);
+                    updateSlots();
+                };
+
+            slot.onOpenEditor = [this](int /*band*/, int position) { openEditor(position); };
+        }
+
+        updateSlots();
+        setSize(360, 60 + XPulseAudioProcessor::kMaxInserts * 40);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colours::lightgrey);
+    }
+
+    void resized() override
+    {
+        lengthLabel.setBounds(10, 10, 100, 30);
+        lengthSlider.setBounds(110, 10, 120, 30);
+
+        for (int position = 0; position < XPulseAudioProcessor::kMaxInserts; ++position)
+            slots[position].setBounds(10, 50 + position * 40, getWidth() - 20, 30);
+    }
+
+private:
+    void updateSlots()
+    {
+        auto& pool = audioProcessor.getHostProcessor().getPool();
+        const auto length = audioProcessor.getBandInsertLength(band);
+
+        for (int position = 0; position < XPulseAudioProcessor::kMaxInserts; ++position)
+        {
+            const auto id = audioProcessor.getBandInsertInstanceId(band, position);
+            slots[position].setHasPlugin(id != 0);
+            slots[position].setPluginName(id != 0 ? pool.getInstanceName(id) : juce::String());
+            slots[position].setAlpha(position < length ? 1.0f : 0.5f);
+        }
+    }
+
+    void addInsert(int position, const juce::PluginDescription& desc)
+    {
+        // The plugin loads in the background, the current one keeps running until it's ready
+        slots[position].setPending(true);
+
+        juce::Component::SafePointer<Content> content(this);
+        auto& processor = audioProcessor;
+        const auto chainBand = band;
+
+        processor.getHostProcessor().getPool().createInstanceAsync(desc,
+            [content, &processor, chainBand, position](PluginPool::InstanceId newId)
+            {
+                // The window may have been closed meanwhile, the chain still gets the plugin
+                if (content != nullptr)
+                    content->slots[position].setPending(false);
+
+                if (newId == 0)
+                    return;
+
+                // Close plugin window for this position first (destroys editor safely)
+                if (content != nullptr)
+                    content->pluginWindows[position].reset();
+
+                // The new plugin crossfades in, the old one is destroyed once it has faded out
+                processor.setBandInsertInstanceId(chainBand, position, (uint32_t)newId, true);
+
+                if (content != nullptr)
+                    content->updateSlots();
+            });
+    }
+
+    void removeInsert(int position)
+    {
+        const auto id = audioProcessor.getBandInsertInstanceId(band, position);
+        if (id == 0)
+            return;
+
+        // Close plugin window for this position first (destroys editor safely)
+        pluginWindows[position].reset();
+
+        // The plugin fades out of the chain before the processor destroys it
+        audioProcessor.setBandInsertInstanceId(band, position, 0, true);
+    }
+
+    void openEditor(int position)
+    {
+        const auto id = audioProcessor.getBandInsertInstanceId(band, position);
+        if (id == 0)
+            return;
+
+        // If already open, just bring it forward
+        if (pluginWindows[position])
+        {
+            pluginWindows[position]->setVisible(true);
+            pluginWindows[position]->toFront(true);
+            return;
+        }
+
+        auto ed = audioProcessor.getHostProcessor().getPool().createEditorFor(id);
+        if (!ed)
+            return;
+
+        auto title = ed->getName();
+        pluginWindows[position] = std::make_unique<HostedPluginWindow>(
+            title,
+            std::move(ed),
+            [this, position]()
+            {
+                pluginWindows[position].reset(); // safe: runs async from closeButtonPressed
+            });
+    }
+
+    XPulseAudioProcessor& audioProcessor;
+    const int band;
+
+    juce::Label lengthLabel;
+    juce::Slider lengthSlider;
+
+    BandPluginSlot slots[XPulseAudioProcessor::kMaxInserts];
+    std::unique_ptr<juce::DocumentWindow> pluginWindows[XPulseAudioProcessor::kMaxInserts];
+};
+
+InsertChainWindow::InsertChainWindow(XPulseAudioProcessor& processorRef, int band, const juce::String& bandName, std::function<void()> onCloseFn)
+    : juce::DocumentWindow(bandName + " Inserts", juce::Colours::darkgrey, juce::DocumentWindow::closeButton),
+      onClose(std::move(onCloseFn))
+{
+    setUsingNativeTitleBar(true);
+    setContentOwned(new Content(processorRef, band), true);
+
+    centreWithSize(getWidth(), getHeight());
+    setVisible(true);
+    toFront(true);
+}
+
+InsertChainWindow::~InsertChainWindow() {}
+
+void InsertChainWindow::closeButtonPressed()
+{
+    // The owner resets its pointer to the window, which can't happen inside the close event
+    auto cb = onClose;
+    juce::MessageManager::callAsync([cb]() { if (cb) cb(); });
+}
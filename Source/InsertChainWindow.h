@@ -0,0 +1,22 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "BandPluginSlot.h"
+
+// Serial insert chain of one band: a slot per chain position and the chain length.
+// Positions past the length keep their plugin but are left out of the chain (shown dimmed)
+class InsertChainWindow : public juce::DocumentWindow
+{
+public:
+    InsertChainWindow(XPulseAudioProcessor& processorRef, int band, const juce::String& bandName, std::function<void()> onCloseFn);
+    ~InsertChainWindow() override;
+
+    void closeButtonPressed() override;
+
+private:
+    class Content;
+
+    std::function<void()> onClose;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InsertChainWindow)
+};
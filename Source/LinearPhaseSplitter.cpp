@@ -0,0 +1,201 @@
+#include "LinearPhaseSplitter.h"
+
+//Polls the crossover targets and loads fresh kernels when they move (never touches the audio thread)
+class LinearPhaseSplitter::KernelDesigner : public juce::Thread
+{
+public:
+    KernelDesigner(LinearPhaseSplitter& ownerToUse, const float* designedHz)
+        : juce::Thread("Crossover Kernel Designer"),
+          owner(ownerToUse)
+    {
+        std::copy(designedHz, designedHz + kMaxCrossovers, lastHz);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(kPollIntervalMs);
+
+            // Only the kernels whose crossover actually moved get redesigned
+            for (int k = 0; k < kMaxCrossovers; ++k)
+            {
+                const auto hz = owner.targetHz[k].load(std::memory_order_relaxed);
+                if (hz == lastHz[k])
+                    continue;
+
+                owner.loadKernel(k, hz);
+                lastHz[k] = hz;
+            }
+        }
+    }
+
+private:
+    // Also bounds how often kernels get swapped while a split is being dragged
+    static constexpr int kPollIntervalMs = 30;
+
+    LinearPhaseSplitter& owner;
+    float lastHz[kMaxCrossovers];
+};
+
+LinearPhaseSplitter::LinearPhaseSplitter()
+{
+    for (auto& target : targetHz)
+        target.store(1000.0f, std::memory_order_relaxed);
+
+    for (auto& lowpass : lowpasses)
+        lowpass = std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::Latency{ kPartitionSize }, convolutionQueue);
+}
+
+LinearPhaseSplitter::~LinearPhaseSplitter()
+{
+    if (designer != nullptr)
+        designer->stopThread(2000);
+}
+
+void LinearPhaseSplitter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // The designer reads sampleRate/kernelLength, so keep it parked while they change
+    if (designer != nullptr)
+        designer->stopThread(2000);
+
+    sampleRate = spec.sampleRate;
+    kernelLength = juce::nextPowerOfTwo((int)(sampleRate * kKernelSeconds)) - 1;
+
+    float designedHz[kMaxCrossovers];
+    for (int k = 0; k < kMaxCrossovers; ++k)
+    {
+        designedHz[k] = targetHz[k].load(std::memory_order_relaxed);
+        loadKernel(k, designedHz[k]);
+        lowpasses[k]->prepare(spec);
+    }
+
+    // Partition latency + the kernels' centre tap
+    latencySamples = lowpasses[0]->getLatency() + (kernelLength - 1) / 2;
+
+    dryDelay.setMaximumDelayInSamples(latencySamples);
+    dryDelay.prepare(spec);
+    dryDelay.setDelay((float)latencySamples);
+
+    reset();
+
+    designer = std::make_unique<KernelDesigner>(*this, designedHz);
+    designer->startThread(juce::Thread::Priority::low);
+}
+
+void LinearPhaseSplitter::reset()
+{
+    for (auto& lowpass : lowpasses)
+        lowpass->reset();
+
+    dryDelay.reset();
+
+    quietSamples = 0;
+}
+
+void LinearPhaseSplitter::setTargetCrossovers(const float* crossovers, int numCrossovers)
+{
+    jassert(numCrossovers <= kMaxCrossovers);
+
+    for (int k = 0; k < juce::jmin(numCrossovers, kMaxCrossovers); ++k)
+        targetHz[k].store(crossovers[k], std::memory_order_relaxed);
+}
+
+juce::AudioBuffer<float> LinearPhaseSplitter::designLowpass(float cutoffHz, double rate, int numTaps)
+{
+    jassert(cutoffHz > 0.0f && cutoffHz < (float)(rate * 0.5));
+    jassert(numTaps % 2 == 1);
+
+    juce::AudioBuffer<float> kernel(1, numTaps);
+    auto* h = kernel.getWritePointer(0);
+
+    // Blackman-Harris keeps the stopband around -90 dB
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(h, (size_t)numTaps,
+        juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+
+    const auto centre = (numTaps - 1) / 2;
+    const auto wc = 2.0 * cutoffHz / rate;
+    const auto pi = juce::MathConstants<double>::pi;
+
+    double sum = 0.0;
+    for (int n = 0; n < numTaps; ++n)
+    {
+        const auto x = (double)(n - centre);
+        const auto sinc = (n == centre) ? wc : std::sin(pi * wc * x) / (pi * x);
+
+        h[n] = (float)(h[n] * sinc);
+        sum += h[n];
+    }
+
+    juce::FloatVectorOperations::multiply(h, (float)(1.0 / sum), numTaps);
+    return kernel;
+}
+
+void LinearPhaseSplitter::loadKernel(int crossover, float cutoffHz)
+{
+    // loadImpulseResponse hands the buffer to the convolution queue's thread, which builds
+    // the new engine and lets the audio thread crossfade into it
+    using Conv = juce::dsp::Convolution;
+
+    lowpasses[crossover]->loadImpulseResponse(designLowpass(cutoffHz, sampleRate, kernelLength),
+        sampleRate, Conv::Stereo::no, Conv::Trim::no, Conv::Normalise::no);
+}
+
+void LinearPhaseSplitter::process(const juce::AudioBuffer<float>& input,
+    juce::AudioBuffer<float>& bands,
+    int numBands,
+    int numSamples)
+{
+    numBands = juce::jlimit(BandSplitter::kMinBands, BandSplitter::kMaxBands, numBands);
+
+    const auto numCh = input.getNumChannels();
+    const auto n = (size_t)numSamples;
+    const auto top = numBands - 1;
+
+    jassert(bands.getNumChannels() >= numBands * numCh);
+
+    // Idle convolutions hold stale history, so start over when the band count changes
+    if (numBands != activeNumBands)
+    {
+        activeNumBands = numBands;
+        reset();
+    }
+
+    // Once the kernels and the dry delay hold nothing but zeros, silence in is silence out
+    const auto historySamples = kernelLength + latencySamples;
+    const auto inputSilent = Silence::isDigitalSilence(input, 0, numCh, numSamples);
+
+    quietSamples = inputSilent ? juce::jmin(quietSamples + numSamples, Silence::kMaxCount) : 0;
+
+    if (inputSilent && quietSamples - numSamples >= historySamples)
+    {
+        for (int ch = 0; ch < numBands * numCh; ++ch)
+            bands.clear(ch, 0, numSamples);
+
+        return;
+    }
+
+    const auto in = juce::dsp::AudioBlock<const float>(input).getSubBlock(0, n);
+    const auto allBands = juce::dsp::AudioBlock<float>(bands);
+
+    auto bandBlock = [&](int band)
+        {
+            return allBands.getSubsetChannelBlock((size_t)(band * numCh), (size_t)numCh).getSubBlock(0, n);
+        };
+
+    // band k <- LP(ck) for the lower bands, top band <- delayed dry
+    for (int k = 0; k < top; ++k)
+    {
+        auto out = bandBlock(k);
+        lowpasses[k]->process(juce::dsp::ProcessContextNonReplacing<float>(in, out));
+    }
+
+    auto topBlock = bandBlock(top);
+    dryDelay.process(juce::dsp::ProcessContextNonReplacing<float>(in, topBlock));
+
+    // Difference downwards so every band still sees its lower neighbour's raw lowpass
+    for (int b = top; b > 0; --b)
+        for (int ch = 0; ch < numCh; ++ch)
+            juce::FloatVectorOperations::subtract(bands.getWritePointer(b * numCh + ch),
+                bands.getReadPointer((b - 1) * numCh + ch), numSamples);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "SilenceTracking.h"
+
+// Linear-phase N-band split for mastering.
+//
+//   band 0     = FIR lowpass @ c0 (input)
+//   band k     = FIR lowpass @ ck (input) - FIR lowpass @ ck-1 (input)
+//   band N-1   = delayed input    - FIR lowpass @ cN-2 (input)
+//
+// All lowpass kernels are windowed-sinc designs of the same length, so the bands are
+// complementary by construction and sum back to a delayed copy of the input.
+//
+// The kernels run through juce::dsp::Convolution with a fixed partition size (uniformly
+// partitioned FFT convolution), so the cost per sample does not depend on the host block size
+// or on where the crossovers sit, and grows by one convolution per extra band. Kernels are
+// redesigned on a background thread when a crossover moves; the convolution crossfades to the
+// new kernel on its own.
+//
+// After enough digitally silent input (zeros or denormals) to flush the kernels and the dry delay,
+// processing it would leave every internal buffer unchanged, so such blocks just clear the bands
+// until signal returns.
+class LinearPhaseSplitter
+{
+public:
+    static constexpr int kMaxCrossovers = BandSplitter::kMaxCrossovers;
+
+    LinearPhaseSplitter();
+    ~LinearPhaseSplitter();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Ascending crossover frequencies in Hz (numCrossovers = band count - 1).
+    // Lock-free, callable from any thread (including the audio thread): the designer thread
+    // polls the targets and loads new kernels when they move.
+    void setTargetCrossovers(const float* crossoverHz, int numCrossovers);
+
+    // Total delay of every band relative to the input, valid after prepare()
+    int getLatencySamples() const noexcept { return latencySamples; }
+
+    // Same contract as BandSplitter::process
+    void process(const juce::AudioBuffer<float>& input,
+        juce::AudioBuffer<float>& bands,
+        int numBands,
+        int numSamples);
+
+private:
+    class KernelDesigner;
+
+    // Convolution partition size (also the convolution's own latency)
+    static constexpr int kPartitionSize = 512;
+
+    // Kernel length is rounded up from this to a power of two (minus one, so it has a centre tap)
+    static constexpr double kKernelSeconds = 0.08;
+
+    // Windowed-sinc lowpass, unity gain at DC
+    static juce::AudioBuffer<float> designLowpass(float cutoffHz, double sampleRate, int numTaps);
+
+    void loadKernel(int crossover, float cutoffHz);
+
+    double sampleRate = 44100.0;
+    int kernelLength = 0;
+    int latencySamples = 0;
+    int activeNumBands = 3;
+
+    // Consecutive digitally silent input samples (saturating), compared against the kernels' full history
+    int quietSamples = 0;
+
+    // Mailbox written by any thread, read by the designer thread
+    std::atomic<float> targetHz[kMaxCrossovers];
+
+    // Shared background queue for all the convolutions' engine rebuilds
+    juce::dsp::ConvolutionMessageQueue convolutionQueue;
+    std::unique_ptr<juce::dsp::Convolution> lowpasses[kMaxCrossovers];
+
+    // Delays the dry input by the kernels' latency for the top band
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+
+    std::unique_ptr<KernelDesigner> designer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseSplitter)
+};
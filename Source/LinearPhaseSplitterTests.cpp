@@ -0,0 +1,161 @@
+#include "LinearPhaseSplitter.h"
+
+// The bands are complementary by construction, so for every band count they have to sum to the
+// input delayed by the reported latency whatever the kernels are. That alone would pass with broken
+// kernels too, so each band also has to pass a tone from its own region and block the others' tones
+class LinearPhaseSplitterTests : public juce::UnitTest
+{
+public:
+    LinearPhaseSplitterTests() : juce::UnitTest("LinearPhaseSplitter", "XPulse") {}
+
+    void runTest() override
+    {
+        for (int numBands = BandSplitter::kMinBands; numBands <= BandSplitter::kMaxBands; ++numBands)
+        {
+            beginTest(juce::String(numBands) + " bands sum to the delayed input");
+            testSum(numBands);
+
+            beginTest(juce::String(numBands) + " bands each hold their own region");
+            testRegions(numBands);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kNumChannels = 2;
+    static constexpr int kBlockSize = 512;
+
+    // Only the rounding of the band differences is left
+    static constexpr float kSumTolerance = 1.0e-5f;
+
+    // The kernels are flat to well under this a few transition widths away from their cutoff
+    static constexpr float kPassbandTolerance = 0.01f;
+
+    // -60 dB, the Blackman-Harris stopband sits far below it
+    static constexpr float kMaxLeakage = 0.001f;
+
+    // Steady state blocks the band gains are measured over
+    static constexpr int kMeasuredBlocks = 8;
+
+    // Octaves up from 200 Hz: at 48 kHz the kernels' transitions are only about 50 Hz either side
+    // of the cutoff, so the tones between two crossovers stay well clear of both
+    static void fillCrossovers(float* hz, int numBands)
+    {
+        for (int k = 0; k < numBands - 1; ++k)
+            hz[k] = 200.0f * (float)(1 << k);
+    }
+
+    // Half an octave inside the band, away from every crossover
+    static float toneFor(const float* hz, int band)
+    {
+        return band == 0 ? hz[0] * 0.5f : hz[band - 1] * juce::MathConstants<float>::sqrt2;
+    }
+
+    static void prepareSplitter(LinearPhaseSplitter& splitter, int numBands)
+    {
+        float hz[LinearPhaseSplitter::kMaxCrossovers] = {};
+        fillCrossovers(hz, numBands);
+
+        splitter.setTargetCrossovers(hz, numBands - 1);
+        splitter.prepare({ kSampleRate, (juce::uint32)kBlockSize, (juce::uint32)kNumChannels });
+    }
+
+    // Block by block, the way the processor drives it
+    static void processAll(LinearPhaseSplitter& splitter, juce::AudioBuffer<float>& input,
+        juce::AudioBuffer<float>& bands, int numBands)
+    {
+        for (int start = 0; start < input.getNumSamples(); start += kBlockSize)
+        {
+            const juce::AudioBuffer<float> in(input.getArrayOfWritePointers(), kNumChannels, start, kBlockSize);
+            juce::AudioBuffer<float> out(bands.getArrayOfWritePointers(), bands.getNumChannels(), start, kBlockSize);
+
+            splitter.process(in, out, numBands, kBlockSize);
+        }
+    }
+
+    void testSum(int numBands)
+    {
+        LinearPhaseSplitter splitter;
+        prepareSplitter(splitter, numBands);
+
+        const auto latency = splitter.getLatencySamples();
+        const auto numSamples = (latency / kBlockSize + 2) * kBlockSize;
+
+        juce::AudioBuffer<float> input(kNumChannels, numSamples);
+        input.clear();
+        input.setSample(0, 0, 1.0f);
+        input.setSample(1, 37, 0.5f);
+
+        juce::AudioBuffer<float> bands(BandSplitter::kMaxBands * kNumChannels, numSamples);
+        processAll(splitter, input, bands, numBands);
+
+        float error = 0.0f;
+
+        for (int ch = 0; ch < kNumChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float sum = 0.0f;
+                for (int b = 0; b < numBands; ++b)
+                    sum += bands.getSample(b * kNumChannels + ch, i);
+
+                const auto expected = i >= latency ? input.getSample(ch, i - latency) : 0.0f;
+                error = juce::jmax(error, std::abs(sum - expected));
+            }
+        }
+
+        expectLessThan(error, kSumTolerance, "sum of the bands");
+    }
+
+    void testRegions(int numBands)
+    {
+        float hz[LinearPhaseSplitter::kMaxCrossovers] = {};
+        fillCrossovers(hz, numBands);
+
+        float passbandError = 0.0f;
+        float leakage = 0.0f;
+
+        for (int toneBand = 0; toneBand < numBands; ++toneBand)
+        {
+            LinearPhaseSplitter splitter;
+            prepareSplitter(splitter, numBands);
+
+            // The bands only settle once the kernels hold nothing but tone (the latency covers half
+            // a kernel and more), then a few blocks are measured
+            const auto latency = splitter.getLatencySamples();
+            const auto settled = (2 * latency / kBlockSize + 1) * kBlockSize;
+            const auto numSamples = settled + kMeasuredBlocks * kBlockSize;
+
+            const auto phaseStep = juce::MathConstants<double>::twoPi * toneFor(hz, toneBand) / kSampleRate;
+
+            juce::AudioBuffer<float> input(kNumChannels, numSamples);
+            for (int ch = 0; ch < kNumChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    input.setSample(ch, i, (float)(0.5 * std::sin(phaseStep * i)));
+
+            juce::AudioBuffer<float> bands(BandSplitter::kMaxBands * kNumChannels, numSamples);
+            processAll(splitter, input, bands, numBands);
+
+            // Linear phase, so every band is a scaled copy of the delayed tone and the RMS ratio is its gain
+            const auto inputRms = input.getRMSLevel(0, settled - latency, kMeasuredBlocks * kBlockSize);
+
+            for (int b = 0; b < numBands; ++b)
+            {
+                for (int ch = 0; ch < kNumChannels; ++ch)
+                {
+                    const auto gain = bands.getRMSLevel(b * kNumChannels + ch, settled, kMeasuredBlocks * kBlockSize) / inputRms;
+
+                    if (b == toneBand)
+                        passbandError = juce::jmax(passbandError, std::abs(gain - 1.0f));
+                    else
+                        leakage = juce::jmax(leakage, gain);
+                }
+            }
+        }
+
+        expectLessThan(passbandError, kPassbandTolerance, "gain of each band for its own tone");
+        expectLessThan(leakage, kMaxLeakage, "gain of each band for the other bands' tones");
+    }
+};
+
+static LinearPhaseSplitterTests linearPhaseSplitterTests;
@@ -16,37 +16,14 @@ LowBandWindow::LowBandWindow(XPulseAudioProcessor& processorRef, juce::AudioProc
     lowBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "lowGain", lowBandGainSlider);
     lowBandReverbAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "lowReverbMaster", lowBandReverbSlider);
 
+	// Reverb presets come from the parameter (so they match the processor's preset table) and have
+	// to be in the box before the attachment selects the current one
+	if (auto* presetParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("lowReverbPreset")))
+		lowReverbBox.addItemList(presetParam->choices, 1);
+
 	// Attach ComboBox to the APVTS parameter
 	lowReverbBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "lowReverbPreset", lowReverbBox);
 
-	//// Reverb Slider Listener
- //   lowBandReverbSlider.onValueChange = [this, &processorRef]()
- //       {
- //           float master = lowBandReverbSlider.getValue();
- //           processorRef.lowBandReverbParameters.wetLevel = processorRef.lowBaseWetLevel * master;
- //           processorRef.lowBandReverbParameters.damping = processorRef.lowBaseDamping * master;
- //           processorRef.lowBandReverbParameters.width = processorRef.lowBaseWidth * master;
- //           processorRef.lowBandReverbParameters.roomSize = processorRef.lowBaseRoomSize;
- //           processorRef.lowBandReverbParameters.dryLevel = processorRef.lowBaseDryLevel;
- //           processorRef.lowBandReverbParameters.freezeMode = processorRef.lowBaseFreezeMode;
- //           processorRef.lowBandReverbProcessor.setParameters(processorRef.lowBandReverbParameters);
- //       };
-
-	//// ComboBox Listener
- //   lowReverbBox.onChange = [this, &processorRef]()
- //      {
- //          int presetIndex = lowReverbBox.getSelectedItemIndex();
- //          processorRef.loadReverbPreset(presetIndex, 'l');
-	//	};
-
-	//Populate ComboBox with reverb presets
-	lowReverbBox.addItem("Small Room", 1);
-	lowReverbBox.addItem("Concert Hall", 2);
-	lowReverbBox.addItem("Dark Room", 3);
-	lowReverbBox.addItem("Bright Room", 4);
-	lowReverbBox.addItem("Ambient Room", 5);
-
-
     setSize(400, 200);
 }
 
@@ -17,36 +17,14 @@ MidBandWindow::MidBandWindow(XPulseAudioProcessor& processorRef, juce::AudioProc
     midBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "midGain", midBandGainSlider);
     midBandReverbAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "midReverbMaster", midBandReverbSlider);
 
+	// Reverb presets come from the parameter (so they match the processor's preset table) and have
+	// to be in the box before the attachment selects the current one
+	if (auto* presetParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("midReverbPreset")))
+		midReverbBox.addItemList(presetParam->choices, 1);
+
 	// Attach the ComboBox to the APVTS parameter
 	midReverbBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "midReverbPreset", midReverbBox);
 
-	// Reverb Slider Listener
-   //midBandReverbSlider.onValueChange = [this, &processorRef]()
-   //     {
-		 //  float master = midBandReverbSlider.getValue();
-		 //  processorRef.midBandReverbParameters.wetLevel = processorRef.midBaseWetLevel * master;
-		 //  processorRef.midBandReverbParameters.damping = processorRef.midBaseDamping * master;
-		 //  processorRef.midBandReverbParameters.width = processorRef.midBaseWidth * master;
-		 //  processorRef.midBandReverbParameters.roomSize = processorRef.midBaseRoomSize;
-		 //  processorRef.midBandReverbParameters.dryLevel = processorRef.midBaseDryLevel;
-		 //  processorRef.midBandReverbParameters.freezeMode = processorRef.midBaseFreezeMode;
-		 //  processorRef.midBandReverbProcessor.setParameters(processorRef.midBandReverbParameters);
-	  //  };
-
-   ////ComboBox Listener
-   //midReverbBox.onChange = [this, &processorRef]()
-	  // {
-		 //  int presetIndex = midReverbBox.getSelectedItemIndex();
-		 //  processorRef.loadReverbPreset(presetIndex, 'm');
-	  // };
-
-   //Populate ComboBox with reverb presets
-   midReverbBox.addItem("Small Room", 1);
-   midReverbBox.addItem("Concert Hall", 2);
-   midReverbBox.addItem("Dark Room", 3);
-   midReverbBox.addItem("Bright Room", 4);
-   midReverbBox.addItem("Ambient Room", 5);
-
     setSize(400, 200);
 }
 
@@ -0,0 +1,251 @@
+#include "ModulationMatrix.h"
+
+juce::StringArray ModulationMatrix::getSourceNames()
+{
+    const char* const ranges[kNumRanges] = { "Low", "Mid", "High" };
+    const char* const kinds[kNumSourceKinds] = { "Velocity", "Note Count", "Aftertouch" };
+
+    juce::StringArray names;
+    for (auto* range : ranges)
+        for (auto* kind : kinds)
+            names.add(juce::String(range) + " " + kind);
+
+    return names;
+}
+
+juce::StringArray ModulationMatrix::getDestinationNames()
+{
+    const char* const slots[kNumSlots] = { "Low", "Mid", "High" };
+
+    juce::StringArray names;
+    for (int band = 0; band < kMaxBands; ++band)
+        names.add("Band " + juce::String(band + 1) + " Gain");
+
+    for (int band = 0; band < kMaxBands; ++band)
+        for (int slot = 0; slot < kNumSlots; ++slot)
+            names.add("Band " + juce::String(band + 1) + " Send " + juce::String(slot + 1));
+
+    for (auto* slot : slots)
+        names.add(juce::String(slot) + " Reverb Wet");
+
+    for (int band = 0; band < kMaxBands; ++band)
+        names.add("Band " + juce::String(band + 1) + " Texture Mix");
+
+    jassert(names.size() == kNumDestinations);
+    return names;
+}
+
+void ModulationMatrix::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    ramps.setSize(kNumDestinations, (int)spec.maximumBlockSize);
+
+    for (auto& offset : offsets)
+        offset.reset(spec.sampleRate, kRampSeconds);
+
+    reset();
+}
+
+void ModulationMatrix::reset()
+{
+    std::fill(std::begin(sources), std::end(sources), 0.0f);
+    std::fill(std::begin(heldNotes), std::end(heldNotes), false);
+    std::fill(std::begin(heldCounts), std::end(heldCounts), 0);
+    std::fill(std::begin(maxima), std::end(maxima), 0.0f);
+    std::fill(std::begin(live), std::end(live), false);
+
+    for (auto& offset : offsets)
+        offset.setCurrentAndTargetValue(0.0f);
+
+    numLive = 0;
+    firstEvent = 0;
+    numEvents = 0;
+    hostTime = 0;
+    chunkTime = 0;
+}
+
+void ModulationMatrix::handleMidi(const juce::MidiBuffer& midi, int ignoredChannel)
+{
+    for (const auto metadata : midi)
+    {
+        const auto msg = metadata.getMessage();
+        if (msg.getChannel() == ignoredChannel)
+            continue;
+
+        Event event;
+        event.time = hostTime + metadata.samplePosition;
+
+        if (msg.isNoteOn())
+        {
+            event.type = noteOnEvent;
+            event.note = msg.getNoteNumber();
+            event.value = msg.getVelocity() / 127.0f;
+        }
+        else if (msg.isNoteOff())
+        {
+            event.type = noteOffEvent;
+            event.note = msg.getNoteNumber();
+        }
+        else if (msg.isAftertouch())
+        {
+            event.type = polyPressureEvent;
+            event.note = msg.getNoteNumber();
+            event.value = msg.getAfterTouchValue() / 127.0f;
+        }
+        else if (msg.isChannelPressure())
+        {
+            event.type = channelPressureEvent;
+            event.value = msg.getChannelPressureValue() / 127.0f;
+        }
+        else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+        {
+            event.type = allNotesOffEvent;
+        }
+        else
+        {
+            continue;
+        }
+
+        // A full queue drops the event rather than growing
+        if (numEvents == kMaxEvents)
+            break;
+
+        events[(firstEvent + numEvents++) % kMaxEvents] = event;
+    }
+}
+
+void ModulationMatrix::applyEvent(const Event& event)
+{
+    auto source = [this](int range, int kind) -> float& { return sources[range * kNumSourceKinds + kind]; };
+    auto updateCount = [&](int range) { source(range, noteCount) = juce::jmin(1.0f, heldCounts[range] / (float)kFullScaleNotes); };
+
+    switch (event.type)
+    {
+        case noteOnEvent:
+        {
+            const auto range = getNoteRange(event.note);
+            source(range, velocity) = event.value;
+
+            if (!heldNotes[event.note])
+            {
+                heldNotes[event.note] = true;
+                ++heldCounts[range];
+                updateCount(range);
+            }
+            break;
+        }
+
+        case noteOffEvent:
+        {
+            // Stray note-offs don't take the count below zero
+            const auto range = getNoteRange(event.note);
+            if (heldNotes[event.note])
+            {
+                heldNotes[event.note] = false;
+                --heldCounts[range];
+                updateCount(range);
+            }
+            break;
+        }
+
+        case polyPressureEvent:
+            source(getNoteRange(event.note), aftertouch) = event.value;
+            break;
+
+        case channelPressureEvent:
+            for (int range = 0; range < kNumRanges; ++range)
+                source(range, aftertouch) = event.value;
+            break;
+
+        case allNotesOffEvent:
+            std::fill(std::begin(heldNotes), std::end(heldNotes), false);
+            for (int range = 0; range < kNumRanges; ++range)
+            {
+                heldCounts[range] = 0;
+                updateCount(range);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ModulationMatrix::processSegment(const Route* routes, int numRoutes, int begin, int end)
+{
+    if (begin >= end)
+        return;
+
+    // Sum of the routes into each destination, from the sources as they stand at this segment
+    float targets[kNumDestinations] = {};
+    for (int r = 0; r < numRoutes; ++r)
+        targets[routes[r].destination] += routes[r].depth * sources[routes[r].source];
+
+    for (int i = 0; i < numLive; ++i)
+    {
+        const auto d = liveDestinations[i];
+        auto* ramp = ramps.getWritePointer(d, begin);
+
+        offsets[d].setTargetValue(targets[d]);
+        offsets[d].fillRamp(ramp, end - begin);
+
+        maxima[d] = juce::jmax(maxima[d], juce::FloatVectorOperations::findMaximum(ramp, end - begin));
+    }
+}
+
+void ModulationMatrix::process(const Route* routes, int numRoutes, int numSamples)
+{
+    jassert(numSamples <= ramps.getNumSamples());
+
+    // Routed destinations, plus unrouted ones still gliding back to zero
+    for (int i = 0; i < numLive; ++i)
+        live[liveDestinations[i]] = false;
+
+    numLive = 0;
+
+    auto addLive = [this](int d)
+        {
+            if (!live[d])
+            {
+                live[d] = true;
+                liveDestinations[numLive++] = d;
+            }
+        };
+
+    for (int r = 0; r < numRoutes; ++r)
+        addLive(routes[r].destination);
+
+    for (int d = 0; d < kNumDestinations; ++d)
+    {
+        if (offsets[d].getCurrentValue() != 0.0f)
+            addLive(d);
+
+        maxima[d] = live[d] ? std::numeric_limits<float>::lowest() : 0.0f;
+    }
+
+    // Split the chunk at every event that lands in it (late ones apply at the current position)
+    int pos = 0;
+
+    while (numEvents > 0)
+    {
+        const auto& event = events[firstEvent];
+        if (event.time - chunkTime >= numSamples)
+            break;
+
+        const auto at = (int)juce::jlimit((juce::int64)pos, (juce::int64)numSamples, event.time - chunkTime);
+        processSegment(routes, numRoutes, pos, at);
+        applyEvent(event);
+
+        firstEvent = (firstEvent + 1) % kMaxEvents;
+        --numEvents;
+        pos = at;
+    }
+
+    processSegment(routes, numRoutes, pos, numSamples);
+
+    chunkTime += numSamples;
+}
+
+const float* ModulationMatrix::getRamp(int destination) const noexcept
+{
+    return live[destination] ? ramps.getReadPointer(destination) : nullptr;
+}
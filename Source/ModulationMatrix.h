@@ -0,0 +1,135 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "SmoothedGain.h"
+
+// MIDI-driven modulation of the band parameters.
+//
+// Sources are tracked per note range (the same low / mid / high split as the pitch-dependent MIDI
+// handling): the velocity of the latest note-on, how many notes are held and the aftertouch. A
+// route adds depth * source to one destination (band gain, a hosted plugin send, a reverb or
+// texture wet level), as an offset on the parameter's own 0..1 value.
+//
+// MIDI events are stamped with their input sample time like the performance FX triggers, and each
+// chunk is evaluated in segments between them, so a destination starts moving at the exact sample
+// of the note that moved it. Every routed destination is smoothed into a per-sample ramp.
+//
+// The routing table is a flat array of plain structs the audio thread builds from the parameters
+// each chunk, so there is nothing to lock and evaluating a route is a multiply-add per segment.
+class ModulationMatrix
+{
+public:
+    static constexpr int kMaxBands = BandSplitter::kMaxBands;
+
+    // Hosted plugin sends and reverb windows per band layout
+    static constexpr int kNumSlots = 3;
+
+    // Note ranges the sources are tracked for, split at these notes (low < 48 <= mid < 78 <= high)
+    static constexpr int kNumRanges = 3;
+    static constexpr int kMidRangeStart = 48;
+    static constexpr int kHighRangeStart = 78;
+
+    enum SourceKind { velocity = 0, noteCount, aftertouch, kNumSourceKinds };
+    static constexpr int kNumSources = kNumRanges * kNumSourceKinds;
+
+    // Held notes that count as a full-scale note count source
+    static constexpr int kFullScaleNotes = 4;
+
+    // Destination layout: band gains, sends (band-major), reverb wet per slot, texture mix per band
+    static constexpr int kFirstGain = 0;
+    static constexpr int kFirstSend = kFirstGain + kMaxBands;
+    static constexpr int kFirstReverbWet = kFirstSend + kMaxBands * kNumSlots;
+    static constexpr int kFirstTextureMix = kFirstReverbWet + kNumSlots;
+    static constexpr int kNumDestinations = kFirstTextureMix + kMaxBands;
+
+    static constexpr int gainDestination(int band) noexcept { return kFirstGain + band; }
+    static constexpr int sendDestination(int band, int slot) noexcept { return kFirstSend + band * kNumSlots + slot; }
+    static constexpr int reverbWetDestination(int slot) noexcept { return kFirstReverbWet + slot; }
+    static constexpr int textureMixDestination(int band) noexcept { return kFirstTextureMix + band; }
+
+    static constexpr int kMaxRoutes = 16;
+
+    // Source = range * kNumSourceKinds + kind
+    struct Route
+    {
+        int source = 0;
+        int destination = 0;
+        float depth = 0.0f;         // -1..1
+    };
+
+    // Names for the parameter choices, in index order
+    static juce::StringArray getSourceNames();
+    static juce::StringArray getDestinationNames();
+
+    static int getNoteRange(int note) noexcept { return note < kMidRangeStart ? 0 : note < kHighRangeStart ? 1 : 2; }
+
+    ModulationMatrix() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Queues the events of a host block (ignoring ignoredChannel, 1-16). Call once per host block
+    // before its audio is processed, then endHostBlock() after it
+    void handleMidi(const juce::MidiBuffer& midi, int ignoredChannel);
+    void endHostBlock(int numSamples) noexcept { hostTime += numSamples; }
+
+    // The block engine starts over from the current host block (after a mode switch)
+    void syncToHostBlock() noexcept { chunkTime = hostTime; }
+
+    // Evaluates the routes over the next chunk of numSamples
+    void process(const Route* routes, int numRoutes, int numSamples);
+
+    // Offset ramp for a destination over the last processed chunk, nullptr while it isn't modulated
+    const float* getRamp(int destination) const noexcept;
+
+    // Largest offset in the destination's ramp (0 while it isn't modulated)
+    float getMaximum(int destination) const noexcept { return maxima[destination]; }
+
+private:
+    // One queued MIDI event, reduced to what the sources need
+    struct Event
+    {
+        juce::int64 time = 0;       // input sample time
+        int type = 0;
+        int note = 0;
+        float value = 0.0f;
+    };
+
+    enum EventType { noteOnEvent = 0, noteOffEvent, polyPressureEvent, channelPressureEvent, allNotesOffEvent };
+
+    static constexpr int kMaxEvents = 512;
+
+    // Offsets glide to a new value over this long
+    static constexpr double kRampSeconds = 0.005;
+
+    void applyEvent(const Event& event);
+
+    // Ramps every live destination over [begin, end) of the chunk
+    void processSegment(const Route* routes, int numRoutes, int begin, int end);
+
+    // Per range: latest velocity, held note count, aftertouch
+    float sources[kNumSources] = {};
+    bool heldNotes[128] = {};
+    int heldCounts[kNumRanges] = {};
+
+    SmoothedGain offsets[kNumDestinations];
+    float maxima[kNumDestinations] = {};
+
+    // Destinations with a route or an offset still returning to zero this chunk
+    int liveDestinations[kNumDestinations] = {};
+    int numLive = 0;
+    bool live[kNumDestinations] = {};
+
+    // One channel per destination, maximum chunk size
+    juce::AudioBuffer<float> ramps;
+
+    juce::int64 hostTime = 0;
+    juce::int64 chunkTime = 0;
+
+    // FIFO of pending events (audio thread only)
+    Event events[kMaxEvents];
+    int firstEvent = 0;
+    int numEvents = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
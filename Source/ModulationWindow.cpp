@@ -0,0 +1,72 @@
+#include "ModulationWindow.h"
+
+ModulationWindow::ModulationWindow(juce::AudioProcessorValueTreeState& apvts)
+    : apvtsRef(apvts)
+{
+    // Route selector (the controls follow it)
+    for (int route = 0; route < ModulationMatrix::kMaxRoutes; ++route)
+        routeBox.addItem("Route " + juce::String(route + 1), route + 1);
+
+    routeBox.onChange = [this]() { attachRoute(routeBox.getSelectedItemIndex()); };
+    addAndMakeVisible(routeBox);
+
+    sourceLabel.setText("Source", juce::dontSendNotification);
+    destinationLabel.setText("Destination", juce::dontSendNotification);
+    depthLabel.setText("Depth", juce::dontSendNotification);
+    addAndMakeVisible(sourceLabel);
+    addAndMakeVisible(destinationLabel);
+    addAndMakeVisible(depthLabel);
+
+    // Every route has the same choices, so the boxes are filled once from the first route's parameters
+    // (they have to be in the box before an attachment selects the current one)
+    if (auto* sourceParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(XPulseAudioProcessor::getModulationParamId(0, "Source"))))
+        sourceBox.addItemList(sourceParam->choices, 1);
+
+    if (auto* destinationParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(XPulseAudioProcessor::getModulationParamId(0, "Dest"))))
+        destinationBox.addItemList(destinationParam->choices, 1);
+
+    addAndMakeVisible(sourceBox);
+    addAndMakeVisible(destinationBox);
+
+    depthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    addAndMakeVisible(depthSlider);
+
+    routeBox.setSelectedId(1, juce::sendNotificationSync);
+
+    setSize(880, 200);
+}
+
+ModulationWindow::~ModulationWindow() {}
+
+void ModulationWindow::attachRoute(int route)
+{
+    if (route < 0)
+        return;
+
+    // The old attachments have to let go of the controls before the new ones take them
+    sourceAttachment.reset();
+    destinationAttachment.reset();
+    depthAttachment.reset();
+
+    sourceAttachment = std::make_unique<ComboBoxAttachment>(apvtsRef, XPulseAudioProcessor::getModulationParamId(route, "Source"), sourceBox);
+    destinationAttachment = std::make_unique<ComboBoxAttachment>(apvtsRef, XPulseAudioProcessor::getModulationParamId(route, "Dest"), destinationBox);
+    depthAttachment = std::make_unique<SliderAttachment>(apvtsRef, XPulseAudioProcessor::getModulationParamId(route, "Depth"), depthSlider);
+}
+
+void ModulationWindow::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::lightgrey);
+}
+
+void ModulationWindow::resized()
+{
+    routeBox.setBounds(10, 10, 120, 30);
+
+    sourceLabel.setBounds(10, 50, 90, 30);
+    sourceBox.setBounds(100, 50, 200, 30);
+    destinationLabel.setBounds(320, 50, 90, 30);
+    destinationBox.setBounds(410, 50, 200, 30);
+
+    depthLabel.setBounds(10, 90, 90, 30);
+    depthSlider.setBounds(100, 90, 510, 30);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+class ModulationWindow : public juce::Component
+{
+public:
+    ModulationWindow(juce::AudioProcessorValueTreeState& apvts);
+    ~ModulationWindow() override;
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+
+    //Points the controls at the selected route's parameters
+    void attachRoute(int route);
+
+    //Reference to the AudioProcessorValueTreeState
+    juce::AudioProcessorValueTreeState& apvtsRef;
+
+    //Route being edited
+    juce::ComboBox routeBox;
+
+    //Source -> destination, by depth
+    juce::Label sourceLabel, destinationLabel, depthLabel;
+    juce::ComboBox sourceBox, destinationBox;
+    juce::Slider depthSlider;
+    std::unique_ptr<ComboBoxAttachment> sourceAttachment, destinationAttachment;
+    std::unique_ptr<SliderAttachment> depthAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationWindow)
+};
@@ -0,0 +1,299 @@
+#include "PerformanceFX.h"
+
+void PerformanceFX::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    fadeStep = (float)(1.0 / juce::jmax(1.0, kFadeSeconds * sampleRate));
+
+    // The furthest back any effect reads is one beat at the slowest tempo
+    // (a repeat slice, the reversed audio, or half a two-beat tape stop)
+    const auto maxHistory = 60.0 / kMinBpm * sampleRate * juce::jmax(1.0, kMaxReverseBeats, kMaxTapeStopBeats * 0.5);
+    ringCapacity = juce::nextPowerOfTwo((int)std::ceil(maxHistory) + 1);
+    rings.assign((size_t)(kMaxBands * kMaxChannels * ringCapacity), 0.0f);
+
+    reset();
+}
+
+void PerformanceFX::reset()
+{
+    std::fill(rings.begin(), rings.end(), 0.0f);
+
+    for (auto& state : bandStates)
+        state = BandState();
+
+    firstTrigger = 0;
+    numTriggers = 0;
+    hostTime = 0;
+    chunkTime = 0;
+}
+
+void PerformanceFX::handleMidi(const juce::MidiBuffer& midi, const Transport& transport, int midiChannel)
+{
+    // Slices are sized from the clamped tempo, beat positions from the real one
+    const auto samplesPerBeat = 60.0 / juce::jmax(kMinBpm, transport.bpm) * sampleRate;
+    const auto hostSamplesPerBeat = 60.0 / juce::jmax(1.0, transport.bpm) * sampleRate;
+
+    for (const auto metadata : midi)
+    {
+        const auto msg = metadata.getMessage();
+        if (!msg.isNoteOnOrOff() || msg.getChannel() != midiChannel)
+            continue;
+
+        const auto note = msg.getNoteNumber() - kFirstTriggerNote;
+        if (note < 0 || note >= kNumTriggerNotes)
+            continue;
+
+        // A full queue drops the trigger rather than growing
+        if (numTriggers == kMaxTriggers)
+            break;
+
+        auto& trigger = triggers[(firstTrigger + numTriggers++) % kMaxTriggers];
+        trigger.time = hostTime + metadata.samplePosition;
+        trigger.note = note;
+        trigger.on = msg.isNoteOn();
+        trigger.samplesPerBeat = samplesPerBeat;
+        trigger.ppq = transport.hasPosition
+            ? juce::jmax(0.0, transport.ppqPosition + metadata.samplePosition / hostSamplesPerBeat)
+            : -1.0;
+    }
+}
+
+bool PerformanceFX::hasTriggerWithin(int numSamples) const noexcept
+{
+    return numTriggers > 0 && triggers[firstTrigger].time < chunkTime + numSamples;
+}
+
+void PerformanceFX::applyTrigger(const Trigger& trigger, const bool* armed, const Settings& settings, int numBands)
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        if (!armed[band])
+            continue;
+
+        auto& state = bandStates[band];
+
+        // Only the note that engaged the effect releases it
+        if (!trigger.on)
+        {
+            if (state.note == trigger.note)
+                state.blendTarget = 0.0f;
+
+            continue;
+        }
+
+        // Coming from live, fade in. Switching effects takes over straight away
+        const auto engaged = state.effect != none;
+        if (!engaged)
+            state.blend = 0.0f;
+
+        // Switching after the recording froze leaves a gap before the trigger, so new audio
+        // starts at the trigger and reverse plays back from the freeze point instead
+        const auto gap = engaged && state.freezeTime < trigger.time;
+        const auto recordedTo = gap ? state.freezeTime : trigger.time;
+
+        state.note = trigger.note;
+        state.start = trigger.time;
+        state.blendTarget = 1.0f;
+
+        if (trigger.note < kNumRepeatNotes)
+        {
+            // 1, 1/2 ... 1/32 beat, starting on the grid line at or before the trigger
+            const auto beats = 1.0 / (double)(1 << trigger.note);
+            const auto gridOffset = trigger.ppq >= 0.0 && !gap ? std::fmod(trigger.ppq, beats) * trigger.samplesPerBeat : 0.0;
+
+            if (gap)
+                state.recordedFrom = trigger.time;
+
+            state.effect = repeat;
+            state.length = juce::jmax(1, (int)std::round(beats * trigger.samplesPerBeat));
+            state.sliceStart = juce::jmax(state.recordedFrom,
+                trigger.time - juce::jmin((juce::int64)std::round(gridOffset), (juce::int64)state.length - 1));
+            state.freezeTime = state.sliceStart + state.length;
+        }
+        else if (trigger.note == kNumRepeatNotes)
+        {
+            const auto beats = juce::jlimit(1.0 / 32.0, kMaxReverseBeats, settings.reverseBeats);
+            const auto length = (juce::int64)std::round(beats * trigger.samplesPerBeat);
+
+            state.effect = reverse;
+            state.sliceStart = recordedTo;
+            state.length = (int)juce::jlimit((juce::int64)1, juce::jmax((juce::int64)1, recordedTo - state.recordedFrom), length);
+            state.freezeTime = recordedTo;
+        }
+        else
+        {
+            const auto beats = juce::jlimit(1.0 / 32.0, kMaxTapeStopBeats, settings.tapeStopBeats);
+
+            if (gap)
+                state.recordedFrom = trigger.time;
+
+            state.effect = tapeStop;
+            state.length = juce::jmax(1, (int)std::round(beats * trigger.samplesPerBeat));
+            state.freezeTime = trigger.time + state.length;
+        }
+    }
+}
+
+float PerformanceFX::readEffect(const BandState& state, const float* ring, juce::int64 time) const noexcept
+{
+    const auto mask = (juce::int64)ringCapacity - 1;
+
+    // Short fades either side of a loop point
+    auto declick = [&state](juce::int64 k)
+        {
+            const auto fade = (float)juce::jlimit(1, kMaxDeclickSamples, state.length / 4);
+            return juce::jmin(1.0f, (float)(k + 1) / fade, (float)(state.length - k) / fade);
+        };
+
+    switch (state.effect)
+    {
+        case repeat:
+        {
+            const auto k = (time - state.sliceStart) % state.length;
+            return ring[(state.sliceStart + k) & mask] * declick(k);
+        }
+
+        case reverse:
+        {
+            const auto k = (time - state.start) % state.length;
+            return ring[(state.sliceStart - 1 - k) & mask] * declick(k);
+        }
+
+        case tapeStop:
+        {
+            const auto elapsed = (double)(time - state.start);
+            if (elapsed >= state.length)
+                return 0.0f;
+
+            // The speed falls linearly to zero, and the level with it
+            const auto speed = 1.0 - elapsed / state.length;
+            const auto travelled = elapsed - elapsed * elapsed / (2.0 * state.length);
+            const auto whole = (juce::int64)travelled;
+            const auto frac = (float)(travelled - (double)whole);
+
+            const auto a = ring[(state.start + whole) & mask];
+            const auto b = ring[(state.start + whole + 1) & mask];
+            return (a + frac * (b - a)) * (float)speed;
+        }
+
+        default:
+            return 0.0f;
+    }
+}
+
+void PerformanceFX::processSegment(juce::AudioBuffer<float>& bands, const bool* armed, int numBands, int numChannels,
+    int begin, int end)
+{
+    const auto mask = (juce::int64)ringCapacity - 1;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& state = bandStates[band];
+        if (!armed[band] && state.effect == none)
+        {
+            state.recording = false;
+            continue;
+        }
+
+        // Whatever is in the ring from before doesn't join up with this
+        if (!state.recording)
+        {
+            state.recording = true;
+            state.recordedFrom = chunkTime + begin;
+        }
+
+        float* ringPointers[kMaxChannels] = {};
+        float* data[kMaxChannels] = {};
+
+        // Record first, so a repeat's first pass can read the live samples it is looping
+        const auto recordEnd = state.effect == none
+            ? end
+            : (int)juce::jlimit((juce::int64)begin, (juce::int64)end, state.freezeTime - chunkTime);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            ringPointers[ch] = rings.data() + (size_t)((band * kMaxChannels + ch) * ringCapacity);
+            data[ch] = bands.getWritePointer(band * numChannels + ch);
+
+            for (int i = begin; i < recordEnd; ++i)
+                ringPointers[ch][(chunkTime + i) & mask] = data[ch][i];
+        }
+
+        if (state.effect == none)
+            continue;
+
+        for (int i = begin; i < end; ++i)
+        {
+            state.blend = state.blendTarget > state.blend
+                ? juce::jmin(state.blendTarget, state.blend + fadeStep)
+                : juce::jmax(state.blendTarget, state.blend - fadeStep);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto wet = readEffect(state, ringPointers[ch], chunkTime + i);
+                data[ch][i] += state.blend * (wet - data[ch][i]);
+            }
+        }
+
+        // Faded all the way back to live (recording picks up again from the next segment)
+        if (state.blend == 0.0f && state.blendTarget == 0.0f)
+        {
+            state.effect = none;
+            state.note = -1;
+            state.recording = false;
+        }
+    }
+}
+
+void PerformanceFX::process(juce::AudioBuffer<float>& bands, const bool* armed, const Settings& settings,
+    int numBands, int numChannels, int numSamples)
+{
+    numBands = juce::jlimit(1, kMaxBands, numBands);
+    numChannels = juce::jmin(numChannels, (int)kMaxChannels);
+
+    jassert(bands.getNumChannels() >= numBands * numChannels && bands.getNumSamples() >= numSamples);
+
+    // Disarmed bands let go
+    for (int band = 0; band < numBands; ++band)
+        if (!armed[band])
+            bandStates[band].blendTarget = 0.0f;
+
+    // Split the chunk at every trigger that lands in it (late ones apply at the current position)
+    int pos = 0;
+
+    while (numTriggers > 0)
+    {
+        auto trigger = triggers[firstTrigger];
+        if (trigger.time - chunkTime >= numSamples)
+            break;
+
+        const auto at = (int)juce::jlimit((juce::int64)pos, (juce::int64)numSamples, trigger.time - chunkTime);
+        processSegment(bands, armed, numBands, numChannels, pos, at);
+
+        trigger.time = chunkTime + at;
+        applyTrigger(trigger, armed, settings, numBands);
+
+        firstTrigger = (firstTrigger + 1) % kMaxTriggers;
+        --numTriggers;
+        pos = at;
+    }
+
+    processSegment(bands, armed, numBands, numChannels, pos, numSamples);
+
+    chunkTime += numSamples;
+}
+
+void PerformanceFX::skip(int numSamples) noexcept
+{
+    while (numTriggers > 0 && triggers[firstTrigger].time - chunkTime < numSamples)
+    {
+        firstTrigger = (firstTrigger + 1) % kMaxTriggers;
+        --numTriggers;
+    }
+
+    // The rings miss this chunk, so a band armed later starts recording afresh
+    for (auto& state : bandStates)
+        state.recording = false;
+
+    chunkTime += numSamples;
+}
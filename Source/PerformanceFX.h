@@ -0,0 +1,144 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+
+// Tempo-synced performance effects for the bands: buffer repeat (stutter), reverse and tape stop.
+//
+// Armed bands are recorded into a ring indexed by absolute input sample time, so every effect is
+// just a different way of reading that ring back:
+//   repeat   - loops a beat-fraction slice, aligned to the host's beat grid when it has one
+//              (the part of the slice after the trigger plays live the first time round)
+//   reverse  - loops the audio just before the trigger, backwards
+//   tape stop - slows the read position to a halt over a number of beats
+//
+// Triggers are MIDI notes on one channel. Note-ons are stamped with their input sample time when
+// the host block arrives and applied at exactly that sample when the chunk containing it is
+// processed (with fixed blocks that can be a later host block). Releasing the note fades back to
+// the live band.
+//
+// The rings and the trigger queue are sized in prepare(), so engaging an effect only sets a few
+// numbers: no allocation and no locks.
+class PerformanceFX
+{
+public:
+    static constexpr int kMaxBands = BandSplitter::kMaxBands;
+    static constexpr int kMaxChannels = 2;
+
+    enum Effect { none = 0, repeat, reverse, tapeStop };
+
+    // Trigger notes, starting at kFirstTriggerNote: repeats of 1, 1/2 ... 1/32 beat, reverse, tape stop
+    static constexpr int kFirstTriggerNote = 36;
+    static constexpr int kNumRepeatNotes = 6;
+    static constexpr int kNumTriggerNotes = kNumRepeatNotes + 2;
+
+    // Slowest tempo the rings hold a full beat for (slower tempos just get shorter slices)
+    static constexpr double kMinBpm = 40.0;
+    static constexpr double kDefaultBpm = 120.0;
+
+    // Longest reverse / tape stop, in beats
+    static constexpr double kMaxReverseBeats = 1.0;
+    static constexpr double kMaxTapeStopBeats = 2.0;
+
+    // Host tempo and position at the start of a host block
+    struct Transport
+    {
+        double bpm = kDefaultBpm;
+        double ppqPosition = 0.0;
+        bool hasPosition = false;   // only while the host is playing
+    };
+
+    struct Settings
+    {
+        double reverseBeats = 1.0;
+        double tapeStopBeats = 1.0;
+    };
+
+    PerformanceFX() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Queues the trigger notes of a host block (notes on midiChannel, 1-16). Call once per host
+    // block before its audio is processed, then endHostBlock() after it
+    void handleMidi(const juce::MidiBuffer& midi, const Transport& transport, int midiChannel);
+    void endHostBlock(int numSamples) noexcept { hostTime += numSamples; }
+
+    // The block engine starts over from the current host block (after a mode switch)
+    void syncToHostBlock() noexcept { chunkTime = hostTime; }
+
+    // True while a band is playing an effect or fading back from one
+    bool isEngaged(int band) const noexcept { return bandStates[band].effect != none; }
+
+    // True if a queued trigger falls within the next numSamples chunk samples
+    bool hasTriggerWithin(int numSamples) const noexcept;
+
+    // Records the armed bands and replaces the engaged ones in place (BandSplitter's band-major
+    // layout). Triggers only engage armed bands, and a band that loses its arm fades back to live
+    void process(juce::AudioBuffer<float>& bands, const bool* armed, const Settings& settings,
+        int numBands, int numChannels, int numSamples);
+
+    // Stands in for process() on chunks where no band is armed or engaged: moves on to the next
+    // chunk and drops the triggers in this one (there is nothing they could engage), so the queue
+    // doesn't back up and a band armed later reacts to its triggers on time
+    void skip(int numSamples) noexcept;
+
+private:
+    // One queued note
+    struct Trigger
+    {
+        juce::int64 time = 0;       // input sample time
+        int note = 0;               // trigger index (0 .. kNumTriggerNotes - 1)
+        bool on = false;
+        double samplesPerBeat = 0.0;
+        double ppq = -1.0;          // beat position at time (negative without a playing host)
+    };
+
+    struct BandState
+    {
+        int effect = none;
+        int note = -1;              // trigger that engaged it (its note-off releases it)
+        juce::int64 start = 0;      // trigger time
+        juce::int64 sliceStart = 0; // repeat: first sample of the looped slice, reverse: the sample it plays back from
+        int length = 1;             // repeat / reverse loop length, tape stop duration
+        juce::int64 freezeTime = 0; // recording stops here while engaged, so a held loop isn't overwritten
+        juce::int64 recordedFrom = 0; // the ring holds unbroken input from here (up to freezeTime while engaged)
+        bool recording = false;
+        float blend = 0.0f;         // 0 = live, 1 = effect
+        float blendTarget = 0.0f;
+    };
+
+    static constexpr int kMaxTriggers = 256;
+
+    // Engage / release fade, and the declick fades at repeat and reverse loop points
+    static constexpr double kFadeSeconds = 0.005;
+    static constexpr int kMaxDeclickSamples = 64;
+
+    void applyTrigger(const Trigger& trigger, const bool* armed, const Settings& settings, int numBands);
+
+    // Renders [begin, end) of the chunk for every armed or engaged band
+    void processSegment(juce::AudioBuffer<float>& bands, const bool* armed, int numBands, int numChannels, int begin, int end);
+
+    float readEffect(const BandState& state, const float* ring, juce::int64 time) const noexcept;
+
+    double sampleRate = 44100.0;
+    float fadeStep = 1.0f;
+
+    // Per-channel ring capacity (power of two, indexed by time & (capacity - 1))
+    int ringCapacity = 0;
+
+    // kMaxBands * kMaxChannels rings
+    std::vector<float> rings;
+
+    // Input sample time of the current host block's first sample / of the next chunk's first sample
+    juce::int64 hostTime = 0;
+    juce::int64 chunkTime = 0;
+
+    // FIFO of pending triggers (audio thread only)
+    Trigger triggers[kMaxTriggers];
+    int firstTrigger = 0;
+    int numTriggers = 0;
+
+    BandState bandStates[kMaxBands];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceFX)
+};
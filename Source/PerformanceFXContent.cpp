@@ -4,6 +4,52 @@ PerformanceFXContent::PerformanceFXContent(juce::AudioProcessorValueTreeState& a
 {
     titleLabel.setText("Performance FX", juce::dontSendNotification);
     addAndMakeVisible(titleLabel);
+
+    // Shared settings
+    channelLabel.setText("MIDI Channel", juce::dontSendNotification);
+    reverseLabel.setText("Reverse", juce::dontSendNotification);
+    tapeStopLabel.setText("Tape Stop", juce::dontSendNotification);
+    addAndMakeVisible(channelLabel);
+    addAndMakeVisible(reverseLabel);
+    addAndMakeVisible(tapeStopLabel);
+
+    channelSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    addAndMakeVisible(channelSlider);
+    channelAttachment = std::make_unique<SliderAttachment>(apvts, "perfMidiChannel", channelSlider);
+
+    tapeStopSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    addAndMakeVisible(tapeStopSlider);
+    tapeStopAttachment = std::make_unique<SliderAttachment>(apvts, "perfTapeStop", tapeStopSlider);
+
+    // The items have to be in the box before the attachment selects the current one
+    addAndMakeVisible(reverseBox);
+    if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("perfReverseLength")))
+        reverseBox.addItemList(choiceParam->choices, 1);
+    reverseAttachment = std::make_unique<ComboBoxAttachment>(apvts, "perfReverseLength", reverseBox);
+
+    // Trigger note map, from PerformanceFX's note layout
+    juce::String notes;
+    for (int i = 0; i < PerformanceFX::kNumTriggerNotes; ++i)
+    {
+        const auto name = juce::MidiMessage::getMidiNoteName(PerformanceFX::kFirstTriggerNote + i, true, true, 3);
+        const auto effect = i < PerformanceFX::kNumRepeatNotes ? "Repeat 1/" + juce::String(1 << i)
+            : i == PerformanceFX::kNumRepeatNotes ? juce::String("Reverse") : juce::String("Tape Stop");
+
+        notes += (i > 0 ? ",  " : "") + name + " " + effect;
+    }
+
+    notesLabel.setText(notes, juce::dontSendNotification);
+    addAndMakeVisible(notesLabel);
+
+    // Arm toggles
+    for (int band = 0; band < XPulseAudioProcessor::kMaxBands; ++band)
+    {
+        armButtons[band].setButtonText("Band " + juce::String(band + 1));
+        addAndMakeVisible(armButtons[band]);
+        armAttachments[band] = std::make_unique<ButtonAttachment>(apvts, XPulseAudioProcessor::getPerformanceParamId(band, "Arm"), armButtons[band]);
+    }
+
+    setSize(900, 300);
 }
 
 PerformanceFXContent::~PerformanceFXContent() {}
@@ -16,4 +62,16 @@ void PerformanceFXContent::paint(juce::Graphics& g)
 void PerformanceFXContent::resized()
 {
     titleLabel.setBounds(10, 10, 200, 30);
+
+    channelLabel.setBounds(10, 60, 90, 30);
+    channelSlider.setBounds(100, 60, 120, 30);
+    reverseLabel.setBounds(240, 60, 60, 30);
+    reverseBox.setBounds(300, 60, 110, 30);
+    tapeStopLabel.setBounds(430, 60, 70, 30);
+    tapeStopSlider.setBounds(500, 60, 380, 30);
+
+    notesLabel.setBounds(10, 110, 880, 30);
+
+    for (int band = 0; band < XPulseAudioProcessor::kMaxBands; ++band)
+        armButtons[band].setBounds(10 + band * 110, 160, 100, 30);
 }
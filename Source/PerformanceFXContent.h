@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "PluginProcessor.h"
 
 class PerformanceFXContent : public juce::Component
 {
@@ -9,6 +10,25 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 private:
+    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+
     juce::Label titleLabel;
+
+    //Trigger channel and effect lengths (shared by every band)
+    juce::Label channelLabel, reverseLabel, tapeStopLabel;
+    juce::Slider channelSlider, tapeStopSlider;
+    juce::ComboBox reverseBox;
+    std::unique_ptr<SliderAttachment> channelAttachment, tapeStopAttachment;
+    std::unique_ptr<ComboBoxAttachment> reverseAttachment;
+
+    //Which notes trigger what
+    juce::Label notesLabel;
+
+    //Bands the triggers act on
+    juce::ToggleButton armButtons[XPulseAudioProcessor::kMaxBands];
+    std::unique_ptr<ButtonAttachment> armAttachments[XPulseAudioProcessor::kMaxBands];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceFXContent)
 };
@@ -1,4 +1,5 @@
 #include "PerformanceFXEditor.h"
+#include "PerformanceFXContent.h"
 
 PerformanceFXEditor::PerformanceFXEditor(juce::AudioProcessorValueTreeState& apvts)
     : juce::DocumentWindow("Performance FX Editor", juce::Colours::lightgrey, juce::DocumentWindow::allButtons)
@@ -7,6 +8,7 @@ PerformanceFXEditor::PerformanceFXEditor(juce::AudioProcessorValueTreeState& apv
     setResizable(true, false);
     setSize(900, 300);
     setVisible(true);
+    setContentOwned(new PerformanceFXContent(apvts), true);
 }
 
 PerformanceFXEditor::~PerformanceFXEditor() {}
@@ -0,0 +1,84 @@
+#include "PerformanceFX.h"
+
+// Drives PerformanceFX the way the processor does: handleMidi() per host block, then process() on
+// chunks where a band is armed and skip() on the others, then endHostBlock()
+class PerformanceFXTests : public juce::UnitTest
+{
+public:
+    PerformanceFXTests() : juce::UnitTest("PerformanceFX", "XPulse") {}
+
+    void runTest() override
+    {
+        beginTest("A band armed after unarmed blocks triggers on time");
+        {
+            PerformanceFX fx;
+            fx.prepare({ kSampleRate, (juce::uint32)kBlockSize, (juce::uint32)kNumChannels });
+
+            juce::AudioBuffer<float> bands(kNumChannels, kBlockSize);
+            bool armed[PerformanceFX::kMaxBands] = {};
+
+            // More trigger notes than the queue holds, while nothing is armed to take them
+            for (int block = 0; block < kUnarmedBlocks; ++block)
+            {
+                juce::MidiBuffer midi;
+                for (int i = 0; i < kNotesPerBlock; ++i)
+                    midi.addEvent(juce::MidiMessage::noteOn(kMidiChannel, PerformanceFX::kFirstTriggerNote, 1.0f), i * 16);
+
+                fx.handleMidi(midi, {}, kMidiChannel);
+                fx.skip(kBlockSize);
+                fx.endHostBlock(kBlockSize);
+            }
+
+            expect(!fx.hasTriggerWithin(kBlockSize), "no stale triggers left over");
+
+            // Armed now: a reverse mid-block has to start at its own sample, not the unarmed time later
+            armed[0] = true;
+
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(kMidiChannel, kReverseNote, 1.0f), kTriggerAt);
+            fx.handleMidi(midi, {}, kMidiChannel);
+
+            expect(fx.hasTriggerWithin(kBlockSize), "the new trigger falls in this block");
+
+            fillRamp(bands);
+            fx.process(bands, armed, {}, 1, kNumChannels, kBlockSize);
+            fx.endHostBlock(kBlockSize);
+
+            expect(fx.isEngaged(0), "the band plays the effect");
+
+            // Live up to the trigger, fading into the reversed audio from it
+            float liveError = 0.0f;
+            for (int ch = 0; ch < kNumChannels; ++ch)
+                for (int i = 0; i < kTriggerAt; ++i)
+                    liveError = juce::jmax(liveError, std::abs(bands.getSample(ch, i) - rampAt(i)));
+
+            expectEquals(liveError, 0.0f, "output before the trigger");
+            expect(bands.getSample(0, kTriggerAt) != rampAt(kTriggerAt), "output at the trigger");
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 512;
+    static constexpr int kNumChannels = 2;
+    static constexpr int kMidiChannel = 1;
+
+    static constexpr int kUnarmedBlocks = 20;
+    static constexpr int kNotesPerBlock = 16;
+    static constexpr int kTriggerAt = 200;
+
+    // Reverse comes straight after the repeat notes
+    static constexpr int kReverseNote = PerformanceFX::kFirstTriggerNote + PerformanceFX::kNumRepeatNotes;
+
+    // Rising input, so reversed audio differs from live at every sample
+    static float rampAt(int i) { return (float)(i + 1) / (float)kBlockSize; }
+
+    static void fillRamp(juce::AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(ch, i, rampAt(i));
+    }
+};
+
+static PerformanceFXTests performanceFXTests;
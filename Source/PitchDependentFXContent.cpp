@@ -7,7 +7,8 @@
 
 
 PitchDependentFXContent::PitchDependentFXContent(XPulseAudioProcessor& processorRef, juce::AudioProcessorValueTreeState& apvts) 
-    : lowBandWindow(processorRef, apvts), midBandWindow(processorRef, apvts), highBandWindow(processorRef, apvts)
+    : lowBandWindow(processorRef, apvts), midBandWindow(processorRef, apvts), highBandWindow(processorRef, apvts),
+      modulationWindow(apvts)
 {
     titleLabel.setText("Pitch Dependent FX", juce::dontSendNotification);
     addAndMakeVisible(titleLabel);
@@ -19,6 +20,7 @@ PitchDependentFXContent::PitchDependentFXContent(XPulseAudioProcessor& processor
         lowBandWindow.setVisible(true);
         midBandWindow.setVisible(false);
         highBandWindow.setVisible(false);
+        modulationWindow.setVisible(false);
         };
     addAndMakeVisible(lowBandButton);
 
@@ -27,6 +29,7 @@ PitchDependentFXContent::PitchDependentFXContent(XPulseAudioProcessor& processor
         lowBandWindow.setVisible(false);
         midBandWindow.setVisible(true);
         highBandWindow.setVisible(false);
+        modulationWindow.setVisible(false);
         };
     addAndMakeVisible(midBandButton);
 
@@ -35,18 +38,30 @@ PitchDependentFXContent::PitchDependentFXContent(XPulseAudioProcessor& processor
         lowBandWindow.setVisible(false);
         midBandWindow.setVisible(false);
         highBandWindow.setVisible(true);
+        modulationWindow.setVisible(false);
         };
     addAndMakeVisible(highBandButton);
 
+    modulationButton.setButtonText("Modulation");
+    modulationButton.onClick = [this]() {
+        lowBandWindow.setVisible(false);
+        midBandWindow.setVisible(false);
+        highBandWindow.setVisible(false);
+        modulationWindow.setVisible(true);
+        };
+    addAndMakeVisible(modulationButton);
+
     // Add band windows as children, but only one will be visible at a time
     addAndMakeVisible(lowBandWindow);
     addAndMakeVisible(midBandWindow);
     addAndMakeVisible(highBandWindow);
+    addAndMakeVisible(modulationWindow);
 
     // Start with only one visible
     lowBandWindow.setVisible(true);
     midBandWindow.setVisible(false);
     highBandWindow.setVisible(false);
+    modulationWindow.setVisible(false);
 }
 PitchDependentFXContent::~PitchDependentFXContent() {}
 
@@ -63,11 +78,13 @@ void PitchDependentFXContent::resized()
     lowBandButton.setBounds(10, 60, 100, 30);
     midBandButton.setBounds(120, 60, 100, 30);
     highBandButton.setBounds(230, 60, 100, 30);
+    modulationButton.setBounds(340, 60, 100, 30);
 
     // Position the band window component(s)
     lowBandWindow.setBounds(10, 100, 400, 200);
     midBandWindow.setBounds(10, 100, 400, 200);
     highBandWindow.setBounds(10, 100, 400, 200);
+    modulationWindow.setBounds(10, 100, 880, 200);
 }
 
 
@@ -3,6 +3,7 @@
 #include "LowBandWindow.h"
 #include "MidBandWindow.h"
 #include "HighBandWindow.h"
+#include "ModulationWindow.h"
 #include "PluginProcessor.h"
 
 
@@ -19,8 +20,11 @@ private:
     MidBandWindow midBandWindow;
     HighBandWindow highBandWindow;
 
+    //MIDI modulation routes
+    ModulationWindow modulationWindow;
+
     //Buttons to open Band Windows
-	juce::TextButton lowBandButton, midBandButton, highBandButton;
+	juce::TextButton lowBandButton, midBandButton, highBandButton, modulationButton;
 
     juce::Label titleLabel;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDependentFXContent)
@@ -13,43 +13,9 @@
 #include "SpectralMorphFXEditor.h"
 #include "TextureBlendFXEditor.h"
 #include "HostProcessor.h"
+#include "HostedPluginWindow.h"
 #include "BinaryData.h"
 
-//Hosted Plugin Window Class
-class HostedPluginWindow : public juce::DocumentWindow
-{
-public:
-	HostedPluginWindow(const juce::String& title,
-		std::unique_ptr<juce::AudioProcessorEditor> editor,
-		std::function<void()> onCloseFn)
-		: juce::DocumentWindow(title,
-			juce::Colours::darkgrey,
-			juce::DocumentWindow::closeButton),
-		onClose(std::move(onCloseFn))
-	{
-		setUsingNativeTitleBar(true);
-		setResizable(true, true);
-
-		// Window owns the editor component
-		setContentOwned(editor.release(), true);
-
-		centreAroundComponent(juce::Desktop::getInstance().getMainMouseSource().getComponentUnderMouse(), getWidth(), getHeight());
-		setVisible(true);
-		toFront(true);
-	}
-
-	void closeButtonPressed() override
-	{
-		// Dont delete ourselves directly inside the close event.
-		// Ask the owner to reset the unique_ptr on the message thread.
-		auto cb = onClose;
-		juce::MessageManager::callAsync([cb]() { if (cb) cb(); });
-	}
-
-private:
-	std::function<void()> onClose;
-};
-
 
 //==============================================================================
 XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& processorRef)
@@ -62,9 +28,9 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 
 #pragma region Initializations
 	// Add band group components to the editor (for visual separation)
-	addAndMakeVisible(lowBandGroup);
-	addAndMakeVisible(midBandGroup);
-	addAndMakeVisible(highBandGroup);
+	// Band columns start hidden, updateBandLayout() shows the active ones
+	for (auto& group : bandGroups)
+		addChildComponent(group);
 	addAndMakeVisible(bandSplitControlsGroup);
 
 	// Custom Image Assignments
@@ -78,299 +44,72 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 	knob.knobImg = juce::ImageCache::getFromMemory(BinaryData::Knob_png, BinaryData::Knob_pngSize);
 #pragma endregion
 
-#pragma region LowBand
-	//LowBand Components
-	const int lowBand = 0;
-
-	lowBypassButton.setClickingTogglesState(true);
-	lowBypassButton.setImages(onImg, onHoverImg, offImg, offHoverImg);
-	addAndMakeVisible(lowBypassButton);
-	lowBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "lowGain", lowBypassButton);
-
-	//Bus1 Logic
-	//Button
-	lowBypassBus1Button.setClickingTogglesState(true);
-	lowBypassBus1Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(lowBypassBus1Button);
-	//Knob
-	lowBandBus1LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	lowBandBus1LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	lowBandBus1LevelSlider.setRange(0.0, 1.0, 0.001);
-	lowBandBus1LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-
-	lowBandBus1LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(lowBandBus1LevelSlider);
-
-	// Bus2 Logic
-	lowBypassBus2Button.setClickingTogglesState(true);
-	lowBypassBus2Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(lowBypassBus2Button);
-	lowBandBus2LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	lowBandBus2LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	lowBandBus2LevelSlider.setRange(0.0, 1.0, 0.001);
-	lowBandBus2LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	lowBandBus2LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(lowBandBus2LevelSlider);
-
-	// Bus3 Logic
-	lowBypassBus3Button.setClickingTogglesState(true);
-	lowBypassBus3Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(lowBypassBus3Button);
-	lowBandBus3LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	lowBandBus3LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	lowBandBus3LevelSlider.setRange(0.0, 1.0, 0.001);
-	lowBandBus3LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	lowBandBus3LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(lowBandBus3LevelSlider);
-
-
-	//Apply Send Amount Based on Bypass State
-	auto applyLowSend = [this, lowBand]()
-		{
-			if (lowBypassBus1Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(lowBand, 0, 0.0f);
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(lowBand, 0, (float)lowBandBus1LevelSlider.getValue());
-
-			}
-
-		};
-
-	lowBandBus1LevelSlider.onValueChange = applyLowSend;
-	lowBypassBus1Button.onClick = applyLowSend;
-
-	// Bus2 callback
-	auto applyLowSend2 = [this, lowBand]()
-		{
-			if (lowBypassBus2Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(lowBand, 1, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(lowBand, 1, (float)lowBandBus2LevelSlider.getValue());
-			}
-		};
-	lowBandBus2LevelSlider.onValueChange = applyLowSend2;
-	lowBypassBus2Button.onClick = applyLowSend2;
-
-	// Bus3 callback
-	auto applyLowSend3 = [this, lowBand]()
-		{
-			if (lowBypassBus3Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(lowBand, 2, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(lowBand, 2, (float)lowBandBus3LevelSlider.getValue());
-			}
-		};
-	lowBandBus3LevelSlider.onValueChange = applyLowSend3;
-	lowBypassBus3Button.onClick = applyLowSend3;
-#pragma endregion
-
-#pragma region MidBand
-	//MidBand Components
-	const int midBand = 1;
-
-	midBypassButton.setClickingTogglesState(true);
-	midBypassButton.setImages(onImg, onHoverImg, offImg, offHoverImg);
-	addAndMakeVisible(midBypassButton);
-	midBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "midGain", midBypassButton);
-
-	//Bus1 Logic
-	//Button
-	midBypassBus1Button.setClickingTogglesState(true);
-	midBypassBus1Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(midBypassBus1Button);
-	//Knob
-	midBandBus1LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	midBandBus1LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	midBandBus1LevelSlider.setRange(0.0, 1.0, 0.001);
-	midBandBus1LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	midBandBus1LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(midBandBus1LevelSlider);
-
-	// Bus2 Logic
-	midBypassBus2Button.setClickingTogglesState(true);
-	midBypassBus2Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(midBypassBus2Button);
-	midBandBus2LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	midBandBus2LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	midBandBus2LevelSlider.setRange(0.0, 1.0, 0.001);
-	midBandBus2LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	midBandBus2LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(midBandBus2LevelSlider);
-
-	// Bus3 Logic
-	midBypassBus3Button.setClickingTogglesState(true);
-	midBypassBus3Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(midBypassBus3Button);
-	midBandBus3LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	midBandBus3LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	midBandBus3LevelSlider.setRange(0.0, 1.0, 0.001);
-	midBandBus3LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	midBandBus3LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(midBandBus3LevelSlider);
-
-	//Apply Send Amount Based on Bypass State
-	auto applyMidSend = [this, midBand]()
-		{
-			if (midBypassBus1Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(midBand, 0, 0.0f);
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(midBand, 0, (float)midBandBus1LevelSlider.getValue());
-			}
-		};
-
-	midBandBus1LevelSlider.onValueChange = applyMidSend;
-	midBypassBus1Button.onClick = applyMidSend;
-
-	// Bus2 callback
-	auto applyMidSend2 = [this, midBand]()
-		{
-			if (midBypassBus2Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(midBand, 1, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(midBand, 1, (float)midBandBus2LevelSlider.getValue());
-			}
-		};
-	midBandBus2LevelSlider.onValueChange = applyMidSend2;
-	midBypassBus2Button.onClick = applyMidSend2;
-
-	// Bus3 callback
-	auto applyMidSend3 = [this, midBand]()
-		{
-			if (midBypassBus3Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(midBand, 2, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(midBand, 2, (float)midBandBus3LevelSlider.getValue());
-			}
-		};
-	midBandBus3LevelSlider.onValueChange = applyMidSend3;
-	midBypassBus3Button.onClick = applyMidSend3;
-#pragma endregion
-
-#pragma region HighBand
-	//HighBand Components
-	const int highBand = 2;
-
-	highBypassButton.setClickingTogglesState(true);
-	highBypassButton.setImages(onImg, onHoverImg, offImg, offHoverImg);
-	addAndMakeVisible(highBypassButton);
-	highBandGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "highGain", highBypassButton);
-
-	//Bus1 Logic
-	//Button
-	highBypassBus1Button.setClickingTogglesState(true);
-	highBypassBus1Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(highBypassBus1Button);
-	//Knob
-	highBandBus1LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	highBandBus1LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	highBandBus1LevelSlider.setRange(0.0, 1.0, 0.001);
-	highBandBus1LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	highBandBus1LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(highBandBus1LevelSlider);
-
-	// Bus2 Logic
-	highBypassBus2Button.setClickingTogglesState(true);
-	highBypassBus2Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(highBypassBus2Button);
-	highBandBus2LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	highBandBus2LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	highBandBus2LevelSlider.setRange(0.0, 1.0, 0.001);
-	highBandBus2LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	highBandBus2LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(highBandBus2LevelSlider);
-
-	// Bus3 Logic
-	highBypassBus3Button.setClickingTogglesState(true);
-	highBypassBus3Button.setImages(offImg, offHoverImg, onImg, onHoverImg);
-	addAndMakeVisible(highBypassBus3Button);
-	highBandBus3LevelSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
-	highBandBus3LevelSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-	highBandBus3LevelSlider.setRange(0.0, 1.0, 0.001);
-	highBandBus3LevelSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
-		juce::MathConstants<float>::pi * 3.25f,
-		true);
-	highBandBus3LevelSlider.setLookAndFeel(&knob);
-	addAndMakeVisible(highBandBus3LevelSlider);
-
-	//Apply Send Amount Based on Bypass State
-	auto applyHighSend = [this, highBand]()
-		{
-			if (highBypassBus1Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(highBand, 0, 0.0f);
-			}
-			else
+#pragma region Bands
+	//Band Components (one column per band, built for the maximum band count)
+	for (int band = 0; band < maxBands; ++band)
+	{
+		auto& bypassButton = bandBypassButtons[band];
+		bypassButton.setClickingTogglesState(true);
+		bypassButton.setImages(onImg, onHoverImg, offImg, offHoverImg);
+		addChildComponent(bypassButton);
+		bandGainAttachments[band] = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, XPulseAudioProcessor::getBandGainParamId(band), bypassButton);
+
+		//Insert Chain
+		auto& insertButton = insertButtons[band];
+		insertButton.setButtonText("Inserts");
+		addChildComponent(insertButton);
+		insertButton.onClick = [this, band]()
 			{
-				audioProcessor.setBandSendAmount(highBand, 0, (float)highBandBus1LevelSlider.getValue());
-			}
-		};
+				// If already open, just bring it forward
+				if (insertWindows[band])
+				{
+					insertWindows[band]->toFront(true);
+					return;
+				}
 
-	highBandBus1LevelSlider.onValueChange = applyHighSend;
-	highBypassBus1Button.onClick = applyHighSend;
+				insertWindows[band] = std::make_unique<InsertChainWindow>(audioProcessor, band, getBandName(band, numBands),
+					[this, band]()
+					{
+						insertWindows[band].reset(); // safe: runs async from closeButtonPressed
+					});
+			};
 
-	// Bus2 callback
-	auto applyHighSend2 = [this, highBand]()
+		for (int slot = 0; slot < slotsPerBand; ++slot)
 		{
-			if (highBypassBus2Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(highBand, 1, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(highBand, 1, (float)highBandBus2LevelSlider.getValue());
-			}
-		};
-	highBandBus2LevelSlider.onValueChange = applyHighSend2;
-	highBypassBus2Button.onClick = applyHighSend2;
+			//Button
+			auto& busButton = busBypassButtons[band][slot];
+			busButton.setClickingTogglesState(true);
+			busButton.setImages(offImg, offHoverImg, onImg, onHoverImg);
+			addChildComponent(busButton);
+
+			//Knob
+			auto& busSlider = busLevelSliders[band][slot];
+			busSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+			busSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+			busSlider.setRange(0.0, 1.0, 0.001);
+			busSlider.setRotaryParameters(juce::MathConstants<float>::pi * 1.75f,
+				juce::MathConstants<float>::pi * 3.25f,
+				true);
+			busSlider.setLookAndFeel(&knob);
+			addChildComponent(busSlider);
+
+			//Apply Send Amount Based on Bypass State
+			auto applySend = [this, band, slot]()
+				{
+					if (busBypassButtons[band][slot].getToggleState())
+					{
+						audioProcessor.setBandSendAmount(band, slot, 0.0f);
+					}
+					else
+					{
+						audioProcessor.setBandSendAmount(band, slot, (float)busLevelSliders[band][slot].getValue());
+					}
+				};
 
-	// Bus3 callback
-	auto applyHighSend3 = [this, highBand]()
-		{
-			if (highBypassBus3Button.getToggleState())
-			{
-				audioProcessor.setBandSendAmount(highBand, 2, 0.0f); // Adjust if you have separate send amounts per bus
-			}
-			else
-			{
-				audioProcessor.setBandSendAmount(highBand, 2, (float)highBandBus3LevelSlider.getValue());
-			}
-		};
-	highBandBus3LevelSlider.onValueChange = applyHighSend3;
-	highBypassBus3Button.onClick = applyHighSend3;
+			busSlider.onValueChange = applySend;
+			busButton.onClick = applySend;
+		}
+	}
 #pragma endregion
 
 #pragma region BandSplitControls
@@ -388,6 +127,42 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 	bandSplitSlider.setMinAndMaxValues(48.0, 72.0);
 	addAndMakeVisible(bandSplitSlider);
 
+	// Crossover mode selector (items come from the parameter so they can't drift apart)
+	if (auto* modeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("crossoverMode")))
+		crossoverModeBox.addItemList(modeParam->choices, 1);
+	addAndMakeVisible(crossoverModeBox);
+	crossoverModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "crossoverMode", crossoverModeBox);
+
+	// Block mode selector (host blocks / fixed internal blocks)
+	if (auto* blockParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("blockMode")))
+		blockModeBox.addItemList(blockParam->choices, 1);
+	addAndMakeVisible(blockModeBox);
+	blockModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "blockMode", blockModeBox);
+
+	// Hosting mode selector (realtime / anticipative)
+	if (auto* hostingParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("hostingMode")))
+		hostingModeBox.addItemList(hostingParam->choices, 1);
+	addAndMakeVisible(hostingModeBox);
+	hostingModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "hostingMode", hostingModeBox);
+
+	// Band count selector (item ids are the band counts)
+	for (int n = XPulseAudioProcessor::kMinBands; n <= maxBands; ++n)
+		numBandsBox.addItem(juce::String(n) + " Bands", n);
+	addAndMakeVisible(numBandsBox);
+	numBandsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "numBands", numBandsBox);
+	numBandsBox.onChange = [this]() { updateBandLayout(); };
+
+	// Extra crossovers for more than three bands
+	for (int k = 0; k < numExtraCrossovers; ++k)
+	{
+		auto& slider = extraCrossoverSliders[k];
+		slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+		slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 18);
+		slider.setTextValueSuffix(" Hz");
+		addChildComponent(slider);
+		extraCrossoverAttachments[k] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, XPulseAudioProcessor::getCrossoverParamId(k + 2), slider);
+	}
+
 	// Ensure theres always a minimum gap between the splits to avoid issues in processing
 	const double minGapSemis = 1.0;
 
@@ -396,14 +171,14 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 			return 440.0f * std::pow(2.0f, (midiNote - 69.0f) / 12.0f);
 		};
 
-	auto pushSplitsToProcessor = [this, &midiToHz]()
+	auto pushSplitsToProcessor = [this, midiToHz]()
 		{
 			const double lo = bandSplitSlider.getMinValue();
 			const double hi = bandSplitSlider.getMaxValue();
 			audioProcessor.setBandSplits(midiToHz(lo), midiToHz(hi));
 		};
 
-	bandSplitSlider.onValueChange = [this, &midiToHz, pushSplitsToProcessor, minGapSemis]()
+	bandSplitSlider.onValueChange = [this, pushSplitsToProcessor, minGapSemis]()
 		{
 			auto lo = bandSplitSlider.getMinValue();
 			auto hi = bandSplitSlider.getMaxValue();
@@ -429,14 +204,14 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 #pragma region PluginSlotsSetup
 
 	// Band Plugin Slots Setup
-	for (int idx = 0; idx < 9; ++idx)
+	for (int idx = 0; idx < numSlots; ++idx)
 	{
-		const int band = idx / 3; // 0..2
-		const int slot = idx % 3; // 0..2
+		const int band = getBandForSlot(idx);
+		const int slot = getSlotInBand(idx);
 
 		bandSlots[idx].setBandIndex(band);
 		bandSlots[idx].setSlotIndex(slot);
-		addAndMakeVisible(bandSlots[idx]);
+		addChildComponent(bandSlots[idx]);
 
 		// Keep the menu list fresh when user opens it
 		bandSlots[idx].onRequestRebuildMenuList = [this](int /*band*/, int /*slot*/)
@@ -447,30 +222,37 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 		// Add/Replace
 		bandSlots[idx].onAddReplace = [this, idx](int band, int slot, const juce::PluginDescription& desc)
 			{
+				// The plugin loads in the background, the current one keeps running until it's ready
+				bandSlots[idx].setPending(true);
 
-				// Close plugin window for this slot first (destroys editor safely)
-				pluginWindows[idx].reset();
-
-				// If this slot already had an instance, destroy it
-				if (bandInstanceId[idx] != 0)
-				{
-					// Clear instance id from processor first before destroying
-					audioProcessor.setBandPluginInstanceId(band, slot, 0);
-
-					audioProcessor.getHostProcessor().getPool().destroyInstance(bandInstanceId[idx]);
-					bandInstanceId[idx] = 0;
-				}
-
-				// Create new instance in pool
-				auto newId = audioProcessor.getHostProcessor().getPool().createInstance(desc);
-				bandInstanceId[idx] = newId;
-
-
-				// Route this (band, slot) to the new instance
-				audioProcessor.setBandPluginInstanceId(band, slot, (uint32_t)newId);
+				juce::Component::SafePointer<XPulseAudioProcessorEditor> editor(this);
+				auto& processor = audioProcessor;
 
-				bandSlots[idx].setHasPlugin(newId != 0);
-				bandSlots[idx].setPluginName(newId != 0 ? desc.name : juce::String("-None-"));
+				processor.getHostProcessor().getPool().createInstanceAsync(desc,
+					[editor, &processor, idx, band, slot, name = desc.name](PluginPool::InstanceId newId)
+					{
+						// The editor may have been closed meanwhile, the routing still goes through
+						if (editor != nullptr)
+							editor->bandSlots[idx].setPending(false);
+
+						if (newId == 0)
+							return;
+
+						// Close plugin window for this slot first (destroys editor safely)
+						if (editor != nullptr)
+							editor->pluginWindows[idx].reset();
+
+						// Route this (band, slot) to the new instance, crossfading from the old one,
+						// which the processor destroys once it has faded out
+						processor.setBandPluginInstanceId(band, slot, (uint32_t)newId, true);
+
+						if (editor != nullptr)
+						{
+							editor->bandInstanceId[idx] = newId;
+							editor->bandSlots[idx].setHasPlugin(true);
+							editor->bandSlots[idx].setPluginName(name);
+						}
+					});
 			};
 
 		// Remove
@@ -483,13 +265,9 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 				// Close plugin window for this slot first (destroys editor safely)
 				pluginWindows[idx].reset();
 
-				// Clear routing + reset send/return for this (band, slot)
-				audioProcessor.setBandPluginInstanceId(band, slot, 0);
-				audioProcessor.setBandSendAmount(band, slot, 0.0f);
-				audioProcessor.setBandReturnAmount(band, slot, 1.0f);
-
-				// Destroy instance
-				audioProcessor.getHostProcessor().getPool().destroyInstance(bandInstanceId[idx]);
+				// Clear routing for this (band, slot): the plugin fades out with the send and return it has,
+				// and the processor destroys it once it is silent
+				audioProcessor.setBandPluginInstanceId(band, slot, 0, true);
 				bandInstanceId[idx] = 0;
 
 				bandSlots[idx].setHasPlugin(false);
@@ -535,6 +313,9 @@ XPulseAudioProcessorEditor::XPulseAudioProcessorEditor(XPulseAudioProcessor& pro
 	// Refresh once background scan finishes
 	startTimerHz(2);
 
+	// Show the columns for the current band count
+	updateBandLayout();
+
 #pragma endregion
 
 #pragma endregion 
@@ -559,72 +340,113 @@ void XPulseAudioProcessorEditor::paint (juce::Graphics& g)
 //Component Layout
 void XPulseAudioProcessorEditor::resized()
 {
-	// Layout the four band group components as three even vertical sections and one bottom section
+	// Layout the active band columns as even vertical sections and one bottom section
 	const int bottomHeight = 150;
-	const int bandWidth = getWidth() / 3;
+	const int bandWidth = getWidth() / numBands;
 	const int bandHeight = getHeight() - bottomHeight;
 
-	lowBandGroup.setBounds(0, 0, bandWidth, bandHeight);
-	midBandGroup.setBounds(bandWidth, 0, bandWidth, bandHeight);
-	highBandGroup.setBounds(2 * bandWidth, 0, getWidth() - 2 * bandWidth, bandHeight);
 	bandSplitControlsGroup.setBounds(0, bandHeight, getWidth(), bottomHeight);
 
-	// Low Band Components
-	lowBypassButton.setBounds(10, 30, 100, 30);
-
-	const int busButtonX[3] = { 25, bandWidth + 25, 2 * bandWidth + 25 };
-	const int busKnobX[3]   = { 350, bandWidth + 350, 2 * bandWidth + 350 };
 	const int busYStart = 57.5;
 	const int busSpacing = 130;
-
-	// Low Band Buses
-	lowBypassBus1Button.setBounds(busButtonX[0], busYStart + 0 * busSpacing, 55, 55);
-	lowBandBus1LevelSlider.setBounds(busKnobX[0], busYStart + 0 * busSpacing, 55, 55);
-	lowBypassBus2Button.setBounds(busButtonX[0], busYStart + 1 * busSpacing, 55, 55);
-	lowBandBus2LevelSlider.setBounds(busKnobX[0], busYStart + 1 * busSpacing, 55, 55);
-	lowBypassBus3Button.setBounds(busButtonX[0], busYStart + 2 * busSpacing, 55, 55);
-	lowBandBus3LevelSlider.setBounds(busKnobX[0], busYStart + 2 * busSpacing, 55, 55);
-
-	// Mid Band Components
-	midBypassButton.setBounds(bandWidth + 10, 30, 100, 30);
-	midBypassBus1Button.setBounds(busButtonX[1], busYStart + 0 * busSpacing, 55, 55);
-	midBandBus1LevelSlider.setBounds(busKnobX[1], busYStart + 0 * busSpacing, 55, 55);
-	midBypassBus2Button.setBounds(busButtonX[1], busYStart + 1 * busSpacing, 55, 55);
-	midBandBus2LevelSlider.setBounds(busKnobX[1], busYStart + 1 * busSpacing, 55, 55);
-	midBypassBus3Button.setBounds(busButtonX[1], busYStart + 2 * busSpacing, 55, 55);
-	midBandBus3LevelSlider.setBounds(busKnobX[1], busYStart + 2 * busSpacing, 55, 55);
-
-	// High Band Components
-	highBypassButton.setBounds(2 * bandWidth + 10, 30, 100, 30);
-	highBypassBus1Button.setBounds(busButtonX[2], busYStart + 0 * busSpacing, 55, 55);
-	highBandBus1LevelSlider.setBounds(busKnobX[2], busYStart + 0 * busSpacing, 55, 55);
-	highBypassBus2Button.setBounds(busButtonX[2], busYStart + 1 * busSpacing, 55, 55);
-	highBandBus2LevelSlider.setBounds(busKnobX[2], busYStart + 1 * busSpacing, 55, 55);
-	highBypassBus3Button.setBounds(busButtonX[2], busYStart + 2 * busSpacing, 55, 55);
-	highBandBus3LevelSlider.setBounds(busKnobX[2], busYStart + 2 * busSpacing, 55, 55);
-
-	// Lay out plugin slots: 3 per band, stacked vertically with spacing
 	const int slotHeight = 30;
 	const int slotSpacing = 100;
+
+	// Wide columns: bypass button, plugin slot and level knob side by side.
+	// Narrow columns (lots of bands): plugin slot on top of the button/knob pair
+	const bool stackSlots = bandWidth < 260;
+
 	for (int band = 0; band < numBands; ++band)
 	{
-		int x = band * bandWidth + 75;
-		int yStart = 70;
-		int slotW = bandWidth - 150;
-		for (int s = 0; s < slotsPerBand; ++s)
+		const int x = band * bandWidth;
+		const int w = (band == numBands - 1) ? getWidth() - x : bandWidth;
+
+		bandGroups[band].setBounds(x, 0, w, bandHeight);
+		bandBypassButtons[band].setBounds(x + 10, 30, 100, 30);
+		insertButtons[band].setBounds(x + 120, 30, juce::jmin(100, w - 130), 30);
+
+		for (int slot = 0; slot < slotsPerBand; ++slot)
 		{
-			int slotIdx = band * slotsPerBand + s;
-			int y = yStart + s * (slotHeight + slotSpacing);
-			bandSlots[slotIdx].setBounds(x, y, slotW, slotHeight);
+			const int busY = busYStart + slot * busSpacing;
+			auto& slotComponent = bandSlots[band * slotsPerBand + slot];
+
+			if (stackSlots)
+			{
+				slotComponent.setBounds(x + 10, busY + 10, w - 20, slotHeight);
+				busBypassButtons[band][slot].setBounds(x + 10, busY + slotHeight + 15, 55, 55);
+				busLevelSliders[band][slot].setBounds(x + w - 65, busY + slotHeight + 15, 55, 55);
+			}
+			else
+			{
+				busBypassButtons[band][slot].setBounds(x + 25, busY, 55, 55);
+				busLevelSliders[band][slot].setBounds(x + w - 66, busY, 55, 55);
+				slotComponent.setBounds(x + 75, 70 + slot * (slotHeight + slotSpacing), w - 150, slotHeight);
+			}
 		}
 	}
 
 	// Band Split Controls Components
 	//bandSplitKeyboard.setBounds(10, bandHeight + 20, getWidth(), bottomHeight);
 
-	bandSplitSlider.setBounds(10, bandHeight + 20, getWidth(), bottomHeight);
+	auto splitArea = juce::Rectangle<int>(10, bandHeight + 20, getWidth() - 20, bottomHeight - 30);
+
+	auto selectorArea = splitArea.removeFromRight(160);
+	crossoverModeBox.setBounds(selectorArea.removeFromTop(24));
+	selectorArea.removeFromTop(8);
+	numBandsBox.setBounds(selectorArea.removeFromTop(24));
+	selectorArea.removeFromTop(8);
+	blockModeBox.setBounds(selectorArea.removeFromTop(24));
+	selectorArea.removeFromTop(8);
+	hostingModeBox.setBounds(selectorArea.removeFromTop(24));
+
+	for (int k = numExtraCrossovers - 1; k >= 0; --k)
+		if (extraCrossoverSliders[k].isVisible())
+			extraCrossoverSliders[k].setBounds(splitArea.removeFromRight(80));
+
+	bandSplitSlider.setBounds(splitArea);
+}
+
+void XPulseAudioProcessorEditor::updateBandLayout()
+{
+	numBands = juce::jlimit(XPulseAudioProcessor::kMinBands, maxBands, (int)apvts.getRawParameterValue("numBands")->load());
+
+	for (int band = 0; band < maxBands; ++band)
+	{
+		const bool active = band < numBands;
+
+		bandGroups[band].setText(getBandName(band, numBands));
+		bandGroups[band].setVisible(active);
+		bandBypassButtons[band].setVisible(active);
+		insertButtons[band].setVisible(active);
+
+		// A band that goes away takes its insert window with it
+		if (!active)
+			insertWindows[band].reset();
+
+		for (int slot = 0; slot < slotsPerBand; ++slot)
+		{
+			busBypassButtons[band][slot].setVisible(active);
+			busLevelSliders[band][slot].setVisible(active);
+			bandSlots[band * slotsPerBand + slot].setVisible(active);
+		}
+	}
+
+	// Extra crossover k + 2 only exists with at least k + 4 bands
+	for (int k = 0; k < numExtraCrossovers; ++k)
+		extraCrossoverSliders[k].setVisible(k + 2 < numBands - 1);
+
+	resized();
+}
+
+juce::String XPulseAudioProcessorEditor::getBandName(int band, int numBands)
+{
+	if (band == 0)
+		return "Low Band";
+
+	if (band == numBands - 1)
+		return "High Band";
 
-	
+	return numBands == 3 ? juce::String("Mid Band") : "Mid Band " + juce::String(band);
 }
 
 // Below are custom functions for our editor class
@@ -684,7 +506,7 @@ void XPulseAudioProcessorEditor::rebuildPluginListFromHost()
 
 
 
-	for (int idx = 0; idx < numBands * slotsPerBand; ++idx)
+	for (int idx = 0; idx < numSlots; ++idx)
 		bandSlots[idx].setPluginList(cachedDescs);
 }
 
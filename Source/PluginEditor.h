@@ -15,6 +15,7 @@
 #include "SpectralMorphFXEditor.h"
 #include "TextureBlendFXEditor.h"
 #include "BandPluginSlot.h"
+#include "InsertChainWindow.h"
 
 class HostProcessor;
 //==============================================================================
@@ -161,9 +162,9 @@ private:
 
 	#pragma region BandPluginSlots
 
-	static constexpr int numBands = 3;
-	static constexpr int slotsPerBand = 3;
-	static constexpr int numSlots = numBands * slotsPerBand;
+	static constexpr int maxBands = XPulseAudioProcessor::kMaxBands;
+	static constexpr int slotsPerBand = XPulseAudioProcessor::kNumSlots;
+	static constexpr int numSlots = maxBands * slotsPerBand;
 
 	BandPluginSlot bandSlots[numSlots];
 	PluginPool::InstanceId bandInstanceId[numSlots]{ 0 };
@@ -176,45 +177,28 @@ private:
 
 	#pragma endregion
 
-	// Band group components
-	juce::GroupComponent lowBandGroup{ "lowBandGroup", "Low Band" };
-	juce::GroupComponent midBandGroup{ "midBandGroup", "Mid Band" };
-	juce::GroupComponent highBandGroup{ "highBandGroup", "High Band" };
+	// Active band count (follows the "numBands" parameter)
+	int numBands = 3;
+
+	// Shows the active band columns / crossover controls and lays them out again
+	void updateBandLayout();
+	static juce::String getBandName(int band, int numBands);
+
+	// Band group components (one column per band, only the active ones are visible)
+	juce::GroupComponent bandGroups[maxBands];
 	juce::GroupComponent bandSplitControlsGroup{ "bandSplitControlsGroup", "Band Split Controls" };
 
-	// LowBand components
-	TwoStateHoverButton lowBypassButton{};
-	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> lowBandGainAttachment;
-
-	// Bypass buttons and rotary knobs for 3 slots per band
-	TwoStateHoverButton lowBypassBus1Button{};
-	juce::Slider lowBandBus1LevelSlider;
-	TwoStateHoverButton lowBypassBus2Button{};
-	juce::Slider lowBandBus2LevelSlider;
-	TwoStateHoverButton lowBypassBus3Button{};
-	juce::Slider lowBandBus3LevelSlider;
-
-	// MidBand components
-	TwoStateHoverButton midBypassButton{};
-	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> midBandGainAttachment;
-
-	TwoStateHoverButton midBypassBus1Button{};
-	juce::Slider midBandBus1LevelSlider;
-	TwoStateHoverButton midBypassBus2Button{};
-	juce::Slider midBandBus2LevelSlider;
-	TwoStateHoverButton midBypassBus3Button{};
-	juce::Slider midBandBus3LevelSlider;
-
-	// HighBand components
-	TwoStateHoverButton highBypassButton{};
-	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> highBandGainAttachment;
-
-	TwoStateHoverButton highBypassBus1Button{};
-	juce::Slider highBandBus1LevelSlider;
-	TwoStateHoverButton highBypassBus2Button{};
-	juce::Slider highBandBus2LevelSlider;
-	TwoStateHoverButton highBypassBus3Button{};
-	juce::Slider highBandBus3LevelSlider;
+	// Band bypass buttons (attached to the band gain parameters)
+	TwoStateHoverButton bandBypassButtons[maxBands];
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bandGainAttachments[maxBands];
+
+	// Bypass buttons and rotary knobs for the send slots of each band
+	TwoStateHoverButton busBypassButtons[maxBands][slotsPerBand];
+	juce::Slider busLevelSliders[maxBands][slotsPerBand];
+
+	// Serial insert chain of each band (opens its InsertChainWindow)
+	juce::TextButton insertButtons[maxBands];
+	std::unique_ptr<InsertChainWindow> insertWindows[maxBands];
 
 
 	// Band Split Keyboard
@@ -222,6 +206,27 @@ private:
 	
 	juce::Slider bandSplitSlider{};
 
+	// Crossover Mode (minimum phase / linear phase)
+	juce::ComboBox crossoverModeBox;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> crossoverModeAttachment;
+
+	// Block Mode (host blocks / fixed internal blocks)
+	juce::ComboBox blockModeBox;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> blockModeAttachment;
+
+	// Hosting Mode (realtime / anticipative, one block ahead)
+	juce::ComboBox hostingModeBox;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> hostingModeAttachment;
+
+	// Band count
+	juce::ComboBox numBandsBox;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> numBandsAttachment;
+
+	// Crossovers beyond the two on bandSplitSlider (only shown while enough bands are active)
+	static constexpr int numExtraCrossovers = maxBands - 3;
+	juce::Slider extraCrossoverSliders[numExtraCrossovers];
+	std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> extraCrossoverAttachments[numExtraCrossovers];
+
 
 	//Audio Processor Reference
 	juce::AudioProcessorValueTreeState& apvts;
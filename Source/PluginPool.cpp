@@ -1,35 +1,175 @@
 #include "PluginPool.h"
 #include "atomic"
+#include <thread>
 
 // Important Note: This class is designed to be mostly used from the UI thread.
 // The audio thread only reads from the snapeshot atomic pointer, while the UI
 // thread can mutate the entries map and rebuild the snapshot as needed.
+//
+// Retired snapshots are reclaimed RCU style: a lookup adds itself to the reader count of the
+// epoch it starts in, and publish() moves the epoch on twice, waiting for the old count to drain
+// each time. Every lookup that could have loaded the old pointer has finished after that, so it
+// is deleted right there on the UI thread and the audio thread never frees anything.
+//
+// Removed instances go the same way one level up: unlinked from the snapshot first, then parked
+// until the audio side has passed two quiescent points (markQuiescent()), by which time it has
+// let go of every raw pointer it took before the removal, and only then deleted by the reaper
+// thread. Plugin destructors can be slow, so the UI thread doesn't run them either.
+
+//Wakes up now and then (or when something is retired) and deletes whatever is safe to delete
+class PluginPool::Reaper : public juce::Thread
+{
+public:
+    explicit Reaper(PluginPool& ownerToUse)
+        : juce::Thread("XPulse Plugin Reaper"),
+          owner(ownerToUse)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            reap();
+            wait(kPollMs);
+        }
+    }
+
+private:
+    // Retired instances wait for the audio thread's block boundaries, which come far more often
+    static constexpr int kPollMs = 50;
+
+    void reap()
+    {
+        std::vector<Retired> ready;
+
+        {
+            const juce::ScopedLock sl(owner.retiredLock);
+
+            const auto epoch = owner.quiescentEpoch.load();
+            const auto running = owner.audioRunning.load();
+
+            for (auto it = owner.retired.begin(); it != owner.retired.end();)
+            {
+                if (!running || epoch - it->epoch >= 2)
+                {
+                    ready.push_back(std::move(*it));
+                    it = owner.retired.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        // The destructors run here, outside of the lock
+        ready.clear();
+    }
+
+    PluginPool& owner;
+};
 
 PluginPool::PluginPool(juce::AudioPluginFormatManager& fm)
     : formatManager(fm)
 {
-    std::atomic_store(&snapshot, std::make_shared<Snapshot>());
+    snapshot.store(new Snapshot());
+
+    reaper = std::make_unique<Reaper>(*this);
+    reaper->startThread(juce::Thread::Priority::low);
+
+    loader = std::make_unique<juce::ThreadPool>(1);
+}
+
+PluginPool::~PluginPool()
+{
+    // A load still preparing finishes first (its result is dropped, nobody is left to take it)
+    loader.reset();
+
+    // Nothing is processing any more, whatever the reaper didn't get to goes with the pool
+    reaper->stopThread(4000);
+    reaper.reset();
+
+    delete snapshot.exchange(nullptr);
 }
 
 void PluginPool::prepareToPlay(double sampleRate, int blockSize)
 {
+    const auto rateChanged = sampleRate != sr;
+
     sr = sampleRate;
     bs = blockSize;
+    audioRunning.store(true);
 
     // UI thread call is safest. If host calls prepare on audio thread, it's still okay-ish here,
     // because we don't mutate snapshot structure, only instances. Keep it simple for now.
     for (auto& [id, e] : entries)
         if (e.instance) e.instance->prepareToPlay(sr, bs);
+
+    // Latencies can depend on the rate, so the old probes are dropped (reported latencies meanwhile)
+    // and new ones are taken in the background, once the message thread gets to it
+    if (rateChanged && !entries.empty())
+    {
+        for (auto& [id, e] : entries)
+            e.probe = {};
+
+        rebuildSnapshot();
+
+        juce::WeakReference<PluginPool> weak(this);
+        juce::MessageManager::callAsync([weak]()
+            {
+                if (auto* pool = weak.get())
+                    pool->reprobeAll();
+            });
+    }
+}
+
+void PluginPool::reprobeAll()
+{
+    // The live instances are the audio thread's again as soon as prepareToPlay() returns, so the
+    // probes run on fresh copies of them (same plugin, same state) that are thrown away afterwards
+    for (auto& [id, e] : entries)
+    {
+        if (!e.instance)
+            continue;
+
+        auto load = std::make_shared<PendingLoad>();
+        load->desc = e.desc;
+        load->reprobeFor = id;
+        e.instance->getStateInformation(load->state);
+
+        loadAsync(std::move(load));
+    }
 }
 
 void PluginPool::releaseResources()
 {
     for (auto& [id, e] : entries)
         if (e.instance) e.instance->releaseResources();
+
+    // Nothing to wait for until the next prepareToPlay()
+    audioRunning.store(false);
+    reaper->notify();
+}
+
+int PluginPool::findFreeSlot() const
+{
+    bool used[kMaxInstances] = {};
+    for (const auto& [id, e] : entries)
+        used[id & kSlotMask] = true;
+
+    const auto slot = (int)(std::find(used, used + kMaxInstances, false) - used);
+    return slot < kMaxInstances ? slot : -1;
 }
 
 PluginPool::InstanceId PluginPool::createInstance(const juce::PluginDescription& desc)
 {
+    if (findFreeSlot() < 0)
+    {
+        DBG("PluginPool createInstance failed: no free slot");
+        return 0;
+    }
+
     juce::String error;
 
     auto inst = formatManager.createPluginInstance(desc, sr, bs, error);
@@ -41,10 +181,122 @@ PluginPool::InstanceId PluginPool::createInstance(const juce::PluginDescription&
 
     inst->prepareToPlay(sr, bs);
 
-    const auto id = nextId++;
+    // Measured before the audio thread can see the instance
+    const auto probe = probeLatency(*inst, sr, bs);
+
+    return addEntry(desc, std::move(inst), probe);
+}
+
+void PluginPool::createInstanceAsync(const juce::PluginDescription& desc, CreationCallback callback)
+{
+    auto load = std::make_shared<PendingLoad>();
+    load->desc = desc;
+    load->callback = callback;
+
+    loadAsync(std::move(load));
+}
+
+void PluginPool::loadAsync(std::shared_ptr<PendingLoad> load)
+{
+    juce::WeakReference<PluginPool> weak(this);
+
+    formatManager.createPluginInstanceAsync(load->desc, sr, bs,
+        [weak, load](std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String& error)
+        {
+            juce::ignoreUnused(error);
+
+            auto* pool = weak.get();
+            if (pool == nullptr)
+                return;
+
+            if (instance == nullptr)
+            {
+                DBG("PluginPool loadAsync failed: " + error);
+                if (load->callback) load->callback(0);
+                return;
+            }
+
+            // A copy for a re-probe takes on the live instance's settings first (lookahead and the like)
+            if (load->reprobeFor != 0 && load->state.getSize() > 0)
+                instance->setStateInformation(load->state.getData(), (int)load->state.getSize());
+
+            load->instance = std::move(instance);
+            pool->prepareInBackground(load);
+        });
+}
+
+void PluginPool::prepareInBackground(std::shared_ptr<PendingLoad> load)
+{
+    // Prepared for the rate and size current now, finishLoad() checks they still are
+    load->sampleRate = sr;
+    load->blockSize = bs;
+
+    juce::WeakReference<PluginPool> weak(this);
+
+    loader->addJob([weak, load]()
+        {
+            auto& instance = *load->instance;
+
+            instance.prepareToPlay(load->sampleRate, load->blockSize);
+            warmUp(instance, load->blockSize);
+            load->probe = probeLatency(instance, load->sampleRate, load->blockSize);
+
+            juce::MessageManager::callAsync([weak, load]()
+                {
+                    if (auto* pool = weak.get())
+                        pool->finishLoad(*load);
+                });
+        });
+}
+
+void PluginPool::finishLoad(PendingLoad& load)
+{
+    // The pool was prepared again meanwhile, so is the instance
+    if (load.sampleRate != sr || load.blockSize != bs)
+    {
+        prepareInBackground(std::make_shared<PendingLoad>(std::move(load)));
+        return;
+    }
+
+    // A re-probe hands its result to the live instance (if it's still there) and drops the copy
+    if (load.reprobeFor != 0)
+    {
+        if (auto it = entries.find(load.reprobeFor); it != entries.end())
+        {
+            it->second.probe = load.probe;
+            rebuildSnapshot();
+        }
+
+        retire(std::move(load.instance));
+        return;
+    }
+
+    const auto id = addEntry(load.desc, std::move(load.instance), load.probe);
+
+    if (load.callback)
+        load.callback(id);
+}
+
+PluginPool::InstanceId PluginPool::addEntry(const juce::PluginDescription& desc,
+    std::unique_ptr<juce::AudioPluginInstance> instance, Probe probe)
+{
+    const auto slot = findFreeSlot();
+    if (slot < 0)
+    {
+        DBG("PluginPool addEntry failed: no free slot");
+        retire(std::move(instance));
+        return 0;
+    }
+
+    // Serials wrap long before they could come back round to a live id, but never to 0
+    const auto id = (nextSerial++ << kSlotBits) | (InstanceId)slot;
+    if (nextSerial >= ((InstanceId)1 << (32 - kSlotBits)))
+        nextSerial = 1;
+
     Entry entry;
     entry.desc = desc;
-    entry.instance = std::move(inst);
+    entry.instance = std::move(instance);
+    entry.probe = probe;
     entries.emplace(id, std::move(entry));
 
     rebuildSnapshot();
@@ -57,16 +309,36 @@ void PluginPool::destroyInstance(InstanceId id)
     if (it == entries.end())
         return;
 
-    // Editor must be destroyed by whoever owns it before this call
+    // Editor must be destroyed by whoever owns it before this call. Unlinked first, so no lookup
+    // hands it out any more, then left to the reaper
+    auto instance = std::move(it->second.instance);
     entries.erase(it);
 
     rebuildSnapshot();
+    retire(std::move(instance));
 }
 
 void PluginPool::destroyAll()
 {
+    auto destroyed = std::move(entries);
     entries.clear();
     rebuildSnapshot();
+
+    for (auto& [id, e] : destroyed)
+        retire(std::move(e.instance));
+}
+
+void PluginPool::retire(std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    if (instance == nullptr)
+        return;
+
+    {
+        const juce::ScopedLock sl(retiredLock);
+        retired.push_back({ std::move(instance), quiescentEpoch.load() });
+    }
+
+    reaper->notify();
 }
 
 std::unique_ptr<juce::AudioProcessorEditor> PluginPool::createEditorFor(InstanceId id)
@@ -81,17 +353,139 @@ std::unique_ptr<juce::AudioProcessorEditor> PluginPool::createEditorFor(Instance
     return std::unique_ptr<juce::AudioProcessorEditor>(it->second.instance->createEditor());
 }
 
+juce::String PluginPool::getInstanceName(InstanceId id) const
+{
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return {};
+
+    return it->second.desc.name;
+}
+
+PluginPool::Snapshot::Item PluginPool::readItem(InstanceId id) const
+{
+    auto& count = readers[epoch.load() & 1u];
+    count.fetch_add(1);
+
+    Snapshot::Item item;
+    if (const auto* snap = snapshot.load(); snap != nullptr && id != 0)
+    {
+        const auto& slot = snap->items[id & kSlotMask];
+        if (slot.id == id)
+            item = slot;
+    }
+
+    count.fetch_sub(1);
+    return item;
+}
+
 juce::AudioPluginInstance* PluginPool::getInstanceForAudio(InstanceId id) const
 {
-    auto snap = std::atomic_load(&snapshot);
-    if (!snap)
-        return nullptr;
+    return readItem(id).instance;
+}
+
+int PluginPool::getLatencyForAudio(InstanceId id, const juce::AudioPluginInstance& instance) const
+{
+    const auto reported = instance.getLatencySamples();
+    const auto probe = readItem(id).probe;
+
+    // A plugin that changed its latency since (a lookahead switched on, say) is taken at its word
+    return probe.measured >= 0 && probe.reported == reported ? probe.measured : reported;
+}
+
+void PluginPool::warmUp(juce::AudioPluginInstance& instance, int blockSize)
+{
+    if (blockSize <= 0)
+        return;
+
+    juce::AudioBuffer<float> buffer(juce::jmax(1, instance.getTotalNumInputChannels(), instance.getTotalNumOutputChannels()), blockSize);
+    juce::MidiBuffer midi;
 
-    for (auto& [sid, ptr] : snap->items)
-        if (sid == id)
-            return ptr;
+    for (int i = 0; i < kWarmUpBlocks; ++i)
+    {
+        buffer.clear();
+        instance.processBlock(buffer, midi);
+    }
 
-    return nullptr;
+    instance.reset();
+}
+
+PluginPool::Probe PluginPool::probeLatency(juce::AudioPluginInstance& instance, double sampleRate, int blockSize)
+{
+    Probe probe;
+    probe.reported = instance.getLatencySamples();
+
+    const auto numInputs = instance.getTotalNumInputChannels();
+    const auto numOutputs = instance.getTotalNumOutputChannels();
+    if (numInputs == 0 || numOutputs == 0 || blockSize <= 0)
+        return probe;
+
+    juce::AudioBuffer<float> buffer(juce::jmax(numInputs, numOutputs), blockSize);
+    juce::MidiBuffer midi;
+
+    const auto maxSamples = juce::jmax(probe.reported + blockSize, (int)(sampleRate * kMaxProbeSeconds));
+    float peak = 0.0f;
+    int peakAt = -1;
+    int peakChannel = 0;
+
+    std::vector<double> energy((size_t)numOutputs, 0.0);
+
+    for (int start = 0; start < maxSamples; start += blockSize)
+    {
+        buffer.clear();
+
+        if (start == 0)
+            for (int ch = 0; ch < numInputs; ++ch)
+                buffer.setSample(ch, 0, 1.0f);
+
+        instance.processBlock(buffer, midi);
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+        {
+            const auto* samples = buffer.getReadPointer(ch);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                energy[(size_t)ch] += (double)samples[i] * samples[i];
+
+                if (std::abs(samples[i]) > peak)
+                {
+                    peak = std::abs(samples[i]);
+                    peakAt = start + i;
+                    peakChannel = ch;
+                }
+            }
+        }
+    }
+
+    // The probe shouldn't ring on into the first real block
+    instance.reset();
+
+    // Only a pure delay is taken as latency: a unity peak holding nearly all of the response, from
+    // a plugin that says it has no tail. The peak of a wet-only delay or a reverb's early reflection
+    // is the effect itself, and compensating for it would cancel the effect out
+    const auto unityPeak = std::abs(peak - 1.0f) <= kMaxProbePeakDeviation;
+    const auto concentrated = (double)peak * peak >= kMinProbePeakEnergy * energy[(size_t)peakChannel];
+    const auto noTail = instance.getTailLengthSeconds() == 0.0;
+
+    if (unityPeak && concentrated && noTail)
+    {
+        probe.measured = peakAt;
+    }
+    else if (peak >= kMinMismatchPeak && peakAt != probe.reported)
+    {
+        probe.mismatch = true;
+        DBG("PluginPool probe: " + instance.getName() + " peaks at " + juce::String(peakAt)
+            + " samples but reports " + juce::String(probe.reported) + ", keeping the reported latency");
+    }
+
+    return probe;
+}
+
+bool PluginPool::hasLatencyMismatch(InstanceId id) const
+{
+    auto it = entries.find(id);
+    return it != entries.end() && it->second.probe.mismatch;
 }
 
 bool PluginPool::hasInstance(InstanceId id) const
@@ -101,13 +495,27 @@ bool PluginPool::hasInstance(InstanceId id) const
 
 void PluginPool::rebuildSnapshot()
 {
-    auto newSnap = std::make_shared<Snapshot>();
-    newSnap->items.reserve(entries.size());
+    auto newSnap = std::make_unique<Snapshot>();
 
     for (auto& [id, e] : entries)
-        newSnap->items.emplace_back(id, e.instance.get());
+        newSnap->items[id & kSlotMask] = { id, e.instance.get(), e.probe };
 
-    std::atomic_store(&snapshot, newSnap);
+    publish(std::move(newSnap));
+}
+
+void PluginPool::publish(std::unique_ptr<Snapshot> next)
+{
+    std::unique_ptr<Snapshot> previous(snapshot.exchange(next.release()));
+
+    // A lookup that read the epoch just before a flip counts under the old parity, so one flip
+    // isn't enough. Lookups are a handful of instructions, the waits are too
+    for (int flip = 0; flip < 2; ++flip)
+    {
+        const auto old = epoch.fetch_add(1);
+
+        while (readers[old & 1u].load() != 0)
+            std::this_thread::yield();
+    }
 }
 
 std::vector<PluginPool::InstanceId> PluginPool::findInstancesByType(const juce::PluginDescription& desc) const
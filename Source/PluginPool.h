@@ -14,6 +14,11 @@ public:
     using PluginTypeId = juce::String;
 
     explicit PluginPool(juce::AudioPluginFormatManager& fm);
+    ~PluginPool();
+
+    // Most instances alive at once (an id's low bits are its slot in the audio thread's table)
+    static constexpr int kSlotBits = 7;
+    static constexpr int kMaxInstances = 1 << kSlotBits;
 
     // Lifecycle
     void prepareToPlay(double sampleRate, int blockSize);
@@ -24,12 +29,40 @@ public:
     void destroyInstance(InstanceId id);
     void destroyAll();
 
+    // Gets the new id, or 0 if the plugin couldn't be loaded (UI thread)
+    using CreationCallback = std::function<void(InstanceId)>;
+
+    // Creates an instance without blocking the UI thread: the format loads it (asynchronously where it
+    // can), then it is prepared, warmed up and probed on a background thread, and it only goes into the
+    // audio snapshot once all of that is done. UI thread only
+    void createInstanceAsync(const juce::PluginDescription& desc, CreationCallback callback);
+
     // UI thread only
     std::unique_ptr<juce::AudioProcessorEditor> createEditorFor(InstanceId id);
+    juce::String getInstanceName(InstanceId id) const;
 
-    // Audio thread safe (reads snapshot only)
+    // Audio thread safe (wait-free, one slot of the snapshot)
     juce::AudioPluginInstance* getInstanceForAudio(InstanceId id) const;
 
+    // Audio thread, at a point where no instance pointer from before the current routing is held
+    // any more (the start of a host block). Removed instances are freed after two of these
+    void markQuiescent() noexcept { quiescentEpoch.fetch_add(1); }
+
+    // Quiescent points passed so far. Anything unpublished at epoch e is out of the audio side's
+    // reach once this is e + 2 (or audio stopped), the processor's routing schedules go the same way
+    juce::uint32 getQuiescentEpoch() const noexcept { return quiescentEpoch.load(); }
+
+    // Between prepareToPlay() and releaseResources()
+    bool isAudioRunning() const noexcept { return audioRunning.load(); }
+
+    // Latency to compensate an instance's output for (audio thread safe). The probed latency while
+    // the plugin still reports what it did when it was probed, its reported latency otherwise
+    int getLatencyForAudio(InstanceId id, const juce::AudioPluginInstance& instance) const;
+
+    // True when the probe saw the instance's response peak away from its reported latency, but the
+    // response didn't look like a pure delay, so the reported latency is used regardless (UI thread)
+    bool hasLatencyMismatch(InstanceId id) const;
+
     // Optional helpers
     bool hasInstance(InstanceId id) const;
 
@@ -41,31 +74,144 @@ public:
     std::vector<InstanceId> findInstancesByType(const juce::PluginDescription& desc) const;
 
 private:
+    // Impulse response measurement of a plugin's latency, taken when it is loaded
+    struct Probe
+    {
+        int measured = -1;      // -1 unless the response was a pure delay
+        int reported = 0;       // getLatencySamples() at probe time
+        bool mismatch = false;  // peaked away from the reported latency without being a pure delay
+    };
+
     struct Entry
     {
         juce::PluginDescription desc;
         std::unique_ptr<juce::AudioPluginInstance> instance;
+        Probe probe;
     };
 
-    // Snapshot for audio thread: (id -> raw pointer)
+    // Snapshot for audio thread: (id -> raw pointer, probe), indexed by the id's slot. Immutable once
+    // published, and only ever freed by the UI thread once no lookup can still be reading it
     struct Snapshot
     {
-        std::vector<std::pair<InstanceId, juce::AudioPluginInstance*>> items;
+        struct Item
+        {
+            InstanceId id = 0;
+            juce::AudioPluginInstance* instance = nullptr;
+            Probe probe;
+        };
+
+        Item items[kMaxInstances];
     };
 
+    static constexpr InstanceId kSlotMask = (InstanceId)kMaxInstances - 1;
+
+    // Copies the item for id out of the current snapshot (empty if the id is gone). Wait-free:
+    // the lookup only registers with the reader count of the current epoch while it reads
+    Snapshot::Item readItem(InstanceId id) const;
+
+    // Runs an impulse through a freshly prepared instance and finds where it comes out (UI thread).
+    // Only a response that is a pure delay counts, wet-only delays and reverbs keep the reported latency
+    static Probe probeLatency(juce::AudioPluginInstance& instance, double sampleRate, int blockSize);
+
+    // Runs a few silent blocks through a freshly prepared instance, so whatever it sets up lazily
+    // (buffers, sample streaming, JIT) happens before the audio thread gets it
+    static void warmUp(juce::AudioPluginInstance& instance, int blockSize);
+
+    static constexpr int kWarmUpBlocks = 16;
+
+    // Longest latency the probe looks for
+    static constexpr double kMaxProbeSeconds = 0.5;
+
+    // How far from unity (for a unit impulse in) the peak of a pure delay may be
+    static constexpr float kMaxProbePeakDeviation = 0.1f;
+
+    // Share of its channel's response energy the peak of a pure delay holds at least
+    static constexpr double kMinProbePeakEnergy = 0.9;
+
+    // Weaker responses than this aren't worth flagging when they peak away from the reported latency
+    static constexpr float kMinMismatchPeak = 0.1f;
+
+    // One createInstanceAsync() call on its way to the pool, or a throwaway copy of a live instance
+    // being probed after a rate change
+    struct PendingLoad
+    {
+        juce::PluginDescription desc;
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        Probe probe;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        CreationCallback callback;
+
+        InstanceId reprobeFor = 0;      // the live instance the probe is for, 0 for a new instance
+        juce::MemoryBlock state;        // the live instance's state, for the copy
+    };
+
+    // First slot of the audio thread's table no entry has, or -1 (UI thread)
+    int findFreeSlot() const;
+
+    // Adds a prepared and probed instance and publishes it. 0 (and the instance retired) without a free slot
+    InstanceId addEntry(const juce::PluginDescription& desc, std::unique_ptr<juce::AudioPluginInstance> instance, Probe probe);
+
+    // Has the format load load->desc (asynchronously where it can), then prepares it in the background
+    void loadAsync(std::shared_ptr<PendingLoad> load);
+
+    // Probes copies of every instance again, without touching the ones the audio thread uses (UI thread)
+    void reprobeAll();
+
+    // Prepares a loaded instance on the loader thread, then finishes the load back on the UI thread
+    void prepareInBackground(std::shared_ptr<PendingLoad> load);
+    void finishLoad(PendingLoad& load);
+
     void rebuildSnapshot(); // UI thread
 
+    // Publishes a snapshot and frees the previous one once every lookup that could see it is done (UI thread)
+    void publish(std::unique_ptr<Snapshot> next);
+
+    class Reaper;
+
+    // An unlinked instance waiting for the audio side to let go of it
+    struct Retired
+    {
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        juce::uint32 epoch = 0;     // quiescentEpoch when it was unlinked
+    };
+
+    // Hands an unlinked instance to the reaper thread (UI thread)
+    void retire(std::unique_ptr<juce::AudioPluginInstance> instance);
+
     juce::AudioPluginFormatManager& formatManager;
 
     double sr = 44100.0;
     int bs = 512;
 
-    InstanceId nextId = 1;
+    // High bits of the next id, so an id that was destroyed never matches its slot's next instance
+    InstanceId nextSerial = 1;
 
     // UI-thread-owned authoritative storage
     std::unordered_map<InstanceId, Entry> entries;
 
     // Audio-thread-readable snapshot
-    std::shared_ptr<Snapshot> snapshot;
+    std::atomic<Snapshot*> snapshot{ nullptr };
+
+    // Lookups in flight, counted under the parity of the epoch they started in
+    mutable std::atomic<juce::uint32> epoch{ 0 };
+    mutable std::atomic<int> readers[2]{};
+
+    // Deferred destruction: instances are deleted on the reaper thread, never on the UI or audio thread
+    juce::CriticalSection retiredLock;
+    std::vector<Retired> retired;
+    std::unique_ptr<Reaper> reaper;
+
+    std::atomic<juce::uint32> quiescentEpoch{ 0 };
+
+    // Between prepareToPlay() and releaseResources(), outside of that nothing is processing
+    std::atomic<bool> audioRunning{ false };
+
+    // Background preparation of asynchronously created instances
+    std::unique_ptr<juce::ThreadPool> loader;
+
+    friend class PluginPoolTests;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PluginPool)
 };
 
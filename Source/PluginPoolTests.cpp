@@ -0,0 +1,159 @@
+#include "PluginPool.h"
+
+// A stereo delay line with a dry/wet mix and feedback, standing in for a hosted plugin. Latency
+// and tail are whatever it is told to report, so it can pass for a lookahead plugin as well as an
+// echo on a send
+class DelayLinePlugin : public juce::AudioPluginInstance
+{
+public:
+    struct Settings
+    {
+        int delaySamples = 0;
+        float wet = 1.0f;
+        float dry = 0.0f;
+        float feedback = 0.0f;
+        int reportedLatency = 0;
+        double tailSeconds = 0.0;
+    };
+
+    explicit DelayLinePlugin(const Settings& settingsToUse)
+        : juce::AudioPluginInstance(BusesProperties()
+              .withInput("Input", juce::AudioChannelSet::stereo(), true)
+              .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+          settings(settingsToUse)
+    {
+        setLatencySamples(settings.reportedLatency);
+    }
+
+    void fillInPluginDescription(juce::PluginDescription& description) const override
+    {
+        description.name = getName();
+        description.pluginFormatName = "Internal";
+        description.numInputChannels = 2;
+        description.numOutputChannels = 2;
+    }
+
+    const juce::String getName() const override { return "Delay Line"; }
+
+    void prepareToPlay(double, int) override
+    {
+        line.setSize(2, settings.delaySamples + 1);
+        reset();
+    }
+
+    void releaseResources() override {}
+
+    void reset() override
+    {
+        line.clear();
+        position = 0;
+    }
+
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+    {
+        const auto length = line.getNumSamples();
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto readAt = (position + 1) % length;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                const auto in = buffer.getSample(ch, i);
+                const auto delayed = line.getSample(ch, readAt);
+
+                line.setSample(ch, position, in + settings.feedback * delayed);
+                buffer.setSample(ch, i, settings.dry * in + settings.wet * delayed);
+            }
+
+            position = readAt;
+        }
+    }
+
+    double getTailLengthSeconds() const override { return settings.tailSeconds; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+private:
+    Settings settings;
+
+    // Ring buffer of delaySamples + 1, written at position and read one ahead of it
+    juce::AudioBuffer<float> line;
+    int position = 0;
+};
+
+// The latency probe may only override the reported latency for a pure delay. Anything else (an echo,
+// a delay with feedback, a dry/wet mix) keeps the reported latency, and is flagged when it peaks elsewhere
+class PluginPoolTests : public juce::UnitTest
+{
+public:
+    PluginPoolTests() : juce::UnitTest("PluginPool", "XPulse") {}
+
+    void runTest() override
+    {
+        beginTest("A pure delay is measured, whatever it reports");
+        {
+            const auto unreported = probe({ 300, 1.0f, 0.0f, 0.0f, 0, 0.0 });
+            expectEquals(unreported.measured, 300);
+            expect(!unreported.mismatch);
+
+            const auto reported = probe({ 300, 1.0f, 0.0f, 0.0f, 300, 0.0 });
+            expectEquals(reported.measured, 300);
+            expect(!reported.mismatch);
+
+            // Inverted polarity is still a pure delay
+            expectEquals(probe({ 300, -1.0f, 0.0f, 0.0f, 0, 0.0 }).measured, 300);
+        }
+
+        beginTest("A wet-only echo keeps the reported latency");
+        {
+            const auto echo = probe({ kEchoSamples, 1.0f, 0.0f, 0.0f, 0, kEchoSeconds });
+            expectEquals(echo.measured, -1);
+            expect(echo.mismatch);
+        }
+
+        beginTest("An echo that repeats keeps the reported latency, even without a tail");
+        {
+            const auto repeats = probe({ kEchoSamples / 4, 1.0f, 0.0f, 0.5f, 0, 0.0 });
+            expectEquals(repeats.measured, -1);
+            expect(repeats.mismatch);
+        }
+
+        beginTest("A dry/wet mix keeps the reported latency");
+        {
+            const auto mix = probe({ kEchoSamples, 0.5f, 0.5f, 0.0f, 0, kEchoSeconds });
+            expectEquals(mix.measured, -1);
+            expect(!mix.mismatch);
+        }
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 512;
+
+    // A 375 ms echo, the usual send delay
+    static constexpr double kEchoSeconds = 0.375;
+    static constexpr int kEchoSamples = (int)(kSampleRate * kEchoSeconds);
+
+    static PluginPool::Probe probe(const DelayLinePlugin::Settings& settings)
+    {
+        DelayLinePlugin plugin(settings);
+        plugin.prepareToPlay(kSampleRate, kBlockSize);
+
+        return PluginPool::probeLatency(plugin, kSampleRate, kBlockSize);
+    }
+};
+
+static PluginPoolTests pluginPoolTests;
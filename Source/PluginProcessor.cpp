@@ -16,6 +16,7 @@ XPulseAudioProcessor::XPulseAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
@@ -24,19 +25,108 @@ XPulseAudioProcessor::XPulseAudioProcessor()
 #endif
 {
 	// Initialise band plugin instance IDs and send/return amounts to default values
-    for (int b = 0; b < kNumBands; ++b)
+    for (int b = 0; b < kMaxBands; ++b)
     {
         for (int s = 0; s < kNumSlots; ++s)
         {
             bandPluginInstanceId[b][s].store(0, std::memory_order_relaxed);
             bandSendAmount[b][s].store(0.0f, std::memory_order_relaxed);
             bandReturnAmount[b][s].store(1.0f, std::memory_order_relaxed);
+            finishedRouteFades[b * kNumSlots + s].store(0, std::memory_order_relaxed);
         }
+
+        for (int i = 0; i < kMaxInserts; ++i)
+        {
+            bandInsertInstanceId[b][i].store(0, std::memory_order_relaxed);
+            finishedInsertFades[b][i].store(0, std::memory_order_relaxed);
+        }
+
+        bandInsertLength[b].store(kNumSlots, std::memory_order_relaxed);
+    }
+
+    bindParameters();
+    rebuildRoutingSchedule();
+}
+
+void XPulseAudioProcessor::bindParameters()
+{
+    auto bind = [this](const juce::String& id)
+        {
+            auto* value = parameters.getRawParameterValue(id);
+            jassert(value != nullptr); // parameter missing from createParameterLayout
+            return value;
+        };
+
+    for (int band = 0; band < kMaxBands; ++band)
+        boundParameters.bandGain[band] = bind(getBandGainParamId(band));
+
+    for (int k = 0; k < kMaxBands - 1; ++k)
+        boundParameters.crossover[k] = bind(getCrossoverParamId(k));
+
+    boundParameters.numBands = bind("numBands");
+    boundParameters.crossoverMode = bind("crossoverMode");
+    boundParameters.blockMode = bind("blockMode");
+    boundParameters.hostingMode = bind("hostingMode");
+    boundParameters.swapFade = bind("swapFade");
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        boundParameters.dynamicsMode[band] = bind(getDynamicsParamId(band, "Mode"));
+        boundParameters.dynamicsThreshold[band] = bind(getDynamicsParamId(band, "Threshold"));
+        boundParameters.dynamicsRatio[band] = bind(getDynamicsParamId(band, "Ratio"));
+        boundParameters.dynamicsAttack[band] = bind(getDynamicsParamId(band, "Attack"));
+        boundParameters.dynamicsRelease[band] = bind(getDynamicsParamId(band, "Release"));
+        boundParameters.dynamicsMakeup[band] = bind(getDynamicsParamId(band, "Makeup"));
+    }
+
+    for (int slot = 0; slot < BandReverb::kNumSlots; ++slot)
+    {
+        boundParameters.reverbMaster[slot] = bind(getReverbParamId(slot, "Master"));
+        boundParameters.reverbPreset[slot] = bind(getReverbParamId(slot, "Preset"));
+    }
+
+    boundParameters.dynamicsLink = bind("dynamicsLink");
+    boundParameters.dynamicsLookahead = bind("dynamicsLookahead");
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        boundParameters.morphTarget[band] = bind(getMorphParamId(band, "Target"));
+        boundParameters.morphAmount[band] = bind(getMorphParamId(band, "Amount"));
+    }
+
+    boundParameters.morphFftSize = bind("morphFftSize");
+    boundParameters.morphHop = bind("morphHop");
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        boundParameters.textureMix[band] = bind(getTextureParamId(band, "Mix"));
+        boundParameters.textureSize[band] = bind(getTextureParamId(band, "Size"));
+        boundParameters.textureDensity[band] = bind(getTextureParamId(band, "Density"));
+        boundParameters.texturePitch[band] = bind(getTextureParamId(band, "Pitch"));
+        boundParameters.textureSpray[band] = bind(getTextureParamId(band, "Spray"));
+        boundParameters.textureSpread[band] = bind(getTextureParamId(band, "Spread"));
+    }
+
+    for (int band = 0; band < kMaxBands; ++band)
+        boundParameters.performanceArm[band] = bind(getPerformanceParamId(band, "Arm"));
+
+    boundParameters.performanceMidiChannel = bind("perfMidiChannel");
+    boundParameters.performanceReverseLength = bind("perfReverseLength");
+    boundParameters.performanceTapeStop = bind("perfTapeStop");
+
+    for (int route = 0; route < ModulationMatrix::kMaxRoutes; ++route)
+    {
+        boundParameters.modulationSource[route] = bind(getModulationParamId(route, "Source"));
+        boundParameters.modulationDestination[route] = bind(getModulationParamId(route, "Dest"));
+        boundParameters.modulationDepth[route] = bind(getModulationParamId(route, "Depth"));
     }
 }
 
 XPulseAudioProcessor::~XPulseAudioProcessor()
 {
+    cancelPendingUpdate();
+    anticipativeRenderer.release();
+    workerPool.stop();
 }
 
 //==============================================================================
@@ -108,10 +198,17 @@ void XPulseAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
 {
     currentSampleRate = sampleRate;
 
+    auto numCh = getTotalNumOutputChannels();
+
+	// Everything downstream of the block engine sees chunks of at most this size, whatever the host sends
+	// (the chunks carry the sidechain channels along with the main ones)
+    blockEngine.prepare(juce::jmax(numCh, getTotalNumInputChannels()), samplesPerBlock);
+    const auto maxChunk = blockEngine.getMaxChunkSize();
+
     juce::dsp::ProcessSpec spec;
 	spec.sampleRate = getSampleRate();
-	spec.maximumBlockSize = getBlockSize();
-    spec.numChannels = getTotalNumOutputChannels();
+	spec.maximumBlockSize = (juce::uint32)maxChunk;
+    spec.numChannels = numCh;
 
     
     // Gain processor
@@ -119,22 +216,56 @@ void XPulseAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
 
 	// Band filters
 	prepareBandFilters(spec);
-	updateBandFilterCutoffs();
 
-    hostProcessor_.prepareToPlay(sampleRate, samplesPerBlock); // (important for hosted plugins too)
+    hostProcessor_.prepareToPlay(sampleRate, maxChunk); // (important for hosted plugins too)
 
+	// Re-prepared plugins start awake
+    for (auto& entry : hostedActivity)
+    {
+        entry.activity.reset();
+        entry.averageSeconds = 0.0;
+    }
 
-	// Removes per-block heap allocations by pre-sizing buffers
-    auto numCh = getTotalNumOutputChannels();
-    lowBuffer.setSize(numCh, samplesPerBlock);
-    midBuffer.setSize(numCh, samplesPerBlock);
-    highBuffer.setSize(numCh, samplesPerBlock);
-    auxBuffer.setSize(numCh, samplesPerBlock);
+    for (auto* activity : { &insertActivity, &insertFadeActivity })
+    {
+        for (auto& chain : *activity)
+        {
+            for (auto& entry : chain)
+            {
+                entry.activity.reset();
+                entry.averageSeconds = 0.0;
+            }
+        }
+    }
+
+	// Workers are (re)started for the new block period
+    workerPool.start(sampleRate, maxChunk);
+    anticipativeRenderer.prepare(numCh, kMaxHostedSteps, maxChunk, sampleRate);
+
+	// Two return lines per route, for the old and the new instance while it is swapped (see getReturnLine)
+    delayCompensation.prepare(numCh, 2 * kMaxBands * kNumSlots, maxChunk, sampleRate);
+    insertCompensation.prepare(numCh, kMaxBands, maxChunk, sampleRate);
+
+
+	// Buffers are sized once here for the maximum band count and chunk size, never on the audio thread
+    bandBuffers.setSize(kMaxBands * numCh, maxChunk);
+    auxBuffer.setSize(kMaxHostedSteps * numCh, maxChunk);
+    reverbInput.setSize(numCh, maxChunk);
+    sendRamp.setSize(kMaxHostedSteps, maxChunk);
+    insertFadeBuffer.setSize(kMaxBands * numCh, maxChunk);
+
+    activeBlockMode.store((int)boundParameters.blockMode->load(std::memory_order_relaxed), std::memory_order_relaxed);
+    activeAnticipative.store((int)boundParameters.hostingMode->load(std::memory_order_relaxed) == anticipativeHosting, std::memory_order_relaxed);
+    anticipativeRenderer.reset(blockEngine.getChunkSize((BlockEngine::Mode)activeBlockMode.load(std::memory_order_relaxed)));
+    activeHostedLatency.store(getHostedLatency(*routingSchedule.load(std::memory_order_acquire)), std::memory_order_relaxed);
+    setLatencySamples(getReportedLatency());
 	
 }
 
 void XPulseAudioProcessor::releaseResources()
 {
+	anticipativeRenderer.release();
+	workerPool.stop();
 	hostProcessor_.releaseResources();
 }
 
@@ -157,6 +288,13 @@ bool XPulseAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) c
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain (spectral morph target) is optional, mono or stereo
+    const auto sidechain = layouts.getChannelSet(true, 1);
+    if (!sidechain.isDisabled()
+     && sidechain != juce::AudioChannelSet::mono()
+     && sidechain != juce::AudioChannelSet::stereo())
+        return false;
    #endif
 
     return true;
@@ -176,11 +314,28 @@ void XPulseAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+	//Routing changes are picked up here, so the whole block runs with one schedule
+    activeSchedule = routingSchedule.load(std::memory_order_acquire);
+
+	//Nothing here holds an instance from an older routing unless the render thread still has a block
+	//captured with one, removed instances are freed once this happened twice since
+    const auto quiescent = activeAnticipative.load(std::memory_order_relaxed)
+        ? anticipativeRenderer.isOnlyUsing(activeSchedule)
+        : !anticipativeRenderer.isRendering();
+    if (quiescent)
+    {
+        hostProcessor_.getPool().markQuiescent();
+    }
+
 	//Process incoming MIDI messages
 	processMidi(midiMessages);
 
 	//Process audio
 	processAudio(buffer);
+
+	//Performance FX triggers and modulation events are stamped relative to the start of each host block
+    performanceFX.endHostBlock(buffer.getNumSamples());
+    modulationMatrix.endHostBlock(buffer.getNumSamples());
     
 }
 
@@ -226,11 +381,17 @@ juce::AudioProcessorValueTreeState::ParameterLayout XPulseAudioProcessor::create
 
 	//Parameter Creation (ID, Name, Min, Max, Default)
 
+	//Band Count
+    params.push_back(std::make_unique<juce::AudioParameterInt>("numBands", "Bands", kMinBands, kMaxBands, 3));
+
 	//Gain Parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>("midGain","MidGain", 0.0f, 1.0f, 0.5f));
 	params.push_back(std::make_unique<juce::AudioParameterFloat>("lowGain", "LowGain", 0.0f, 1.0f, 0.5f));
 	params.push_back(std::make_unique<juce::AudioParameterFloat>("highGain", "HighGain", 0.0f, 1.0f, 0.5f));
 
+    for (int band = 3; band < kMaxBands; ++band)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getBandGainParamId(band), "Band" + juce::String(band + 1) + "Gain", 0.0f, 1.0f, 0.5f));
+
 	//Band Filters Cutoff Frequencies
     params.push_back(std::make_unique<juce::AudioParameterFloat>("cutoff", "Cutoff", 20.0f, 20000.0f, 1000.0f));
 
@@ -242,455 +403,1710 @@ juce::AudioProcessorValueTreeState::ParameterLayout XPulseAudioProcessor::create
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>("midHighCrossover", "Mid-High Crossover", hzRange, 4000.0f));
 
+	//Extra splits for more than three bands. The active splits are sorted before use, so these
+	//defaults fill the gaps around 250/4000 Hz in a sensible order as bands are added
+    const float extraCrossoverDefaults[] = { 1000.0f, 100.0f, 500.0f, 2000.0f, 8000.0f };
+    for (int k = 2; k < kMaxBands - 1; ++k)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getCrossoverParamId(k), "Crossover " + juce::String(k + 1), hzRange, extraCrossoverDefaults[k - 2]));
 
-	//Return the parameter layout
-	return { params.begin(), params.end() };
-}
+	//Crossover Mode (linear phase adds latency)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("crossoverMode", "Crossover Mode",
+        juce::StringArray{ "Minimum Phase", "Linear Phase" }, (int)minimumPhaseMode));
 
-//Audio Processing Function
-void XPulseAudioProcessor::processAudio(juce::AudioBuffer<float>& buffer) {
-	pitchDependent(buffer);
-}
+	//Block Mode (fixed internal blocks add latency, see BlockEngine)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("blockMode", "Block Mode",
+        juce::StringArray{ "Host Blocks", "Fixed Blocks" }, (int)BlockEngine::hostBlocks));
 
-//MIDI Processing Function
-void XPulseAudioProcessor::processMidi(juce::MidiBuffer& midiMessages) {
-    
-}
+	//Hosting Mode (anticipative runs the hosted plugins a block ahead, adding a chunk of latency)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("hostingMode", "Hosting Mode",
+        juce::StringArray{ "Realtime Hosting", "Anticipative Hosting" }, (int)realtimeHosting));
 
-#pragma region PitchDependentProcessing
-//Pitch-Dependent Processing Function Audio
+	//Swap Fade (ms a hosted plugin or route that gets swapped crossfades over, see RoutingGraph)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("swapFade", "Swap Fade", 1.0f, 200.0f, 20.0f));
 
-void XPulseAudioProcessor::pitchDependent(juce::AudioBuffer<float>& buffer) {
-	//Create copies of the main buffer for each band and ensures buffers are 
-    // the correct size causing no  need to reallocate memory each block
-    lowBuffer.setSize(buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
-    midBuffer.setSize(buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
-    highBuffer.setSize(buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
+	//Per-band Dynamics (compressor/expander after the band split)
+    auto skewedRange = [](float lo, float hi, float centre)
+        {
+            juce::NormalisableRange<float> range(lo, hi);
+            range.setSkewForCentre(centre);
+            return range;
+        };
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    for (int band = 0; band < kMaxBands; ++band)
     {
-        lowBuffer.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
-        midBuffer.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
-        highBuffer.copyFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
+        const auto name = "Band " + juce::String(band + 1) + " Dyn ";
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getDynamicsParamId(band, "Mode"), name + "Mode",
+            juce::StringArray{ "Off", "Compress", "Expand" }, (int)BandDynamics::off));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getDynamicsParamId(band, "Threshold"), name + "Threshold",
+            juce::NormalisableRange<float>(-60.0f, 0.0f), -18.0f, juce::AudioParameterFloatAttributes().withLabel("dB")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getDynamicsParamId(band, "Ratio"), name + "Ratio",
+            skewedRange(1.0f, 20.0f, 4.0f), 4.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getDynamicsParamId(band, "Attack"), name + "Attack",
+            skewedRange(0.1f, 100.0f, 10.0f), 10.0f, juce::AudioParameterFloatAttributes().withLabel("ms")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getDynamicsParamId(band, "Release"), name + "Release",
+            skewedRange(10.0f, 1000.0f, 150.0f), 150.0f, juce::AudioParameterFloatAttributes().withLabel("ms")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getDynamicsParamId(band, "Makeup"), name + "Makeup",
+            juce::NormalisableRange<float>(0.0f, 24.0f), 0.0f, juce::AudioParameterFloatAttributes().withLabel("dB")));
     }
 
-	//Process each band
-	processLowBand(lowBuffer);
-	processMidBand(midBuffer);
-	processHighBand(highBuffer);
-
-    //Runs sends into Hosted Plugins
-    processHostedSends(lowBuffer, midBuffer, highBuffer);
+    params.push_back(std::make_unique<juce::AudioParameterBool>("dynamicsLink", "Dynamics Stereo Link", true));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("dynamicsLookahead", "Dynamics Lookahead", false));
 
-	buffer.clear();
+	//Reverb Parameters (low / mid / high band windows)
+    const char* const reverbSlotNames[] = { "Low", "Mid", "High" };
+    for (int slot = 0; slot < BandReverb::kNumSlots; ++slot)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getReverbParamId(slot, "Master"), juce::String(reverbSlotNames[slot]) + "Reverb", 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getReverbParamId(slot, "Preset"), juce::String(reverbSlotNames[slot]) + "ReverbPreset",
+            BandReverb::getPresetNames(), 0));
+    }
 
-	//Mix the processed bands back into the main buffer
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-        buffer.addFrom(channel, 0, lowBuffer, channel, 0, lowBuffer.getNumSamples());
-        buffer.addFrom(channel, 0, midBuffer, channel, 0, midBuffer.getNumSamples());
-        buffer.addFrom(channel, 0, highBuffer, channel, 0, highBuffer.getNumSamples());
-	}
-}
+	//Spectral Morph Parameters (per band target + amount, shared FFT size / hop)
+    static_assert(SpectralMorph::kMaxBands == kMaxBands, "Morph targets are band indices");
 
-void XPulseAudioProcessor::processLowBand(juce::AudioBuffer<float>& buffer) {
-    //Process Low Band
+    juce::StringArray morphTargets{ "Off" };
+    for (int band = 0; band < kMaxBands; ++band)
+        morphTargets.add("Band " + juce::String(band + 1));
+    morphTargets.add("Sidechain");
 
-    //Apply Low-Pass Filter 
-    //Build an AudioBlock and process it with the DSP processors
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    lowBand.process(context);
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        const auto name = "Band " + juce::String(band + 1) + " Morph ";
 
-    //Apply Gain 
-    float lowGainValue = *parameters.getRawParameterValue("lowGain");    
-    lowGainProcessor.setGainLinear(lowGainValue);
-    lowGainProcessor.process(context);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getMorphParamId(band, "Target"), name + "Target", morphTargets, 0));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getMorphParamId(band, "Amount"), name + "Amount", 0.0f, 1.0f, 0.5f));
+    }
 
-}
+	//FFT size sets the morph stage's latency
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("morphFftSize", "Morph FFT Size", SpectralMorph::getFftSizeNames(), 2));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("morphHop", "Morph Hop", SpectralMorph::getHopNames(), 1));
 
-void XPulseAudioProcessor::processMidBand(juce::AudioBuffer<float>& buffer) {
-    //Process Mid Band
+	//Texture Blend Parameters (per band granular texture)
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        const auto name = "Band " + juce::String(band + 1) + " Texture ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Mix"), name + "Mix", 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Size"), name + "Size",
+            skewedRange(5.0f, TextureBlend::kMaxGrainMs, 80.0f), 80.0f, juce::AudioParameterFloatAttributes().withLabel("ms")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Density"), name + "Density",
+            skewedRange(1.0f, 1000.0f, 50.0f), 50.0f, juce::AudioParameterFloatAttributes().withLabel("grains/s")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Pitch"), name + "Pitch",
+            juce::NormalisableRange<float>(-TextureBlend::kMaxPitchSemitones, TextureBlend::kMaxPitchSemitones), 0.0f,
+            juce::AudioParameterFloatAttributes().withLabel("st")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Spray"), name + "Spray",
+            juce::NormalisableRange<float>(0.0f, TextureBlend::kMaxSprayMs), 100.0f, juce::AudioParameterFloatAttributes().withLabel("ms")));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getTextureParamId(band, "Spread"), name + "Spread", 0.0f, 1.0f, 0.5f));
+    }
 
-    //Apply Band-Pass Filter 
-    //Build an AudioBlock and process it with the DSP processors
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+	//Performance FX Parameters (armed bands respond to the trigger notes on the performance channel)
+    for (int band = 0; band < kMaxBands; ++band)
+        params.push_back(std::make_unique<juce::AudioParameterBool>(getPerformanceParamId(band, "Arm"), "Band " + juce::String(band + 1) + " Perf Arm", false));
 
-    auto& midHP = midBand.get<0>();
-    auto& midLP = midBand.get<1>();
-    midBand.process(context);
+    params.push_back(std::make_unique<juce::AudioParameterInt>("perfMidiChannel", "Performance MIDI Channel", 1, 16, 16));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("perfReverseLength", "Performance Reverse Length",
+        juce::StringArray{ "1/4 Beat", "1/2 Beat", "1 Beat" }, 2));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("perfTapeStop", "Performance Tape Stop",
+        juce::NormalisableRange<float>(0.25f, (float)PerformanceFX::kMaxTapeStopBeats), 1.0f, juce::AudioParameterFloatAttributes().withLabel("beats")));
 
-    //Apply Gain 
-    float midGainValue = *parameters.getRawParameterValue("midGain");
-    midGainProcessor.setGainLinear(midGainValue);
-    midGainProcessor.process(context);
-}
+	//Modulation Matrix Parameters (source -> destination routes, depth is bipolar)
+    static_assert(ModulationMatrix::kMaxBands == kMaxBands && ModulationMatrix::kNumSlots == kNumSlots
+        && ModulationMatrix::kNumSlots == BandReverb::kNumSlots, "Modulation destinations follow the band / slot layout");
 
-void XPulseAudioProcessor::processHighBand(juce::AudioBuffer<float>& buffer) {
-    //Process High Band
+    juce::StringArray modulationSources{ "Off" };
+    modulationSources.addArray(ModulationMatrix::getSourceNames());
+    const auto modulationDestinations = ModulationMatrix::getDestinationNames();
 
-    //Apply High-Pass Filter
-    //Build an AudioBlock and process it with the DSP processors
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    highBand.process(context);
+    for (int route = 0; route < ModulationMatrix::kMaxRoutes; ++route)
+    {
+        const auto name = "Mod " + juce::String(route + 1) + " ";
 
-    //Apply Gain 
-    float highGainValue = *parameters.getRawParameterValue("highGain");
-    highGainProcessor.setGainLinear(highGainValue);
-    highGainProcessor.process(context);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getModulationParamId(route, "Source"), name + "Source", modulationSources, 0));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getModulationParamId(route, "Dest"), name + "Destination", modulationDestinations, 0));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getModulationParamId(route, "Depth"), name + "Depth", -1.0f, 1.0f, 0.5f));
+    }
 
 
+	//Return the parameter layout
+	return { params.begin(), params.end() };
 }
 
-void XPulseAudioProcessor::setBandSplits(float lowMidHz, float midHighHz)
-{
-    lowMidHz = juce::jlimit(20.0f, 20000.0f, lowMidHz);
-    midHighHz = juce::jlimit(20.0f, 20000.0f, midHighHz);
-
-    const float minGapHz = 10.0f;
-    if (midHighHz < lowMidHz + minGapHz)
-        midHighHz = lowMidHz + minGapHz;
+//Audio Processing Function
+void XPulseAudioProcessor::processAudio(juce::AudioBuffer<float>& buffer) {
+    const auto blockMode = (int)boundParameters.blockMode->load(std::memory_order_relaxed);
+    const auto anticipative = (int)boundParameters.hostingMode->load(std::memory_order_relaxed) == anticipativeHosting;
 
-    if (auto* p1 = parameters.getParameter("lowMidCrossover"))
+    if (blockMode != activeBlockMode.load(std::memory_order_relaxed))
     {
-        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p1);
-        jassert(ranged);
+        //Fixed blocks add latency, so the host has to hear about the switch
+        activeBlockMode.store(blockMode, std::memory_order_relaxed);
+        triggerAsyncUpdate();
 
-        p1->beginChangeGesture();
-        p1->setValueNotifyingHost(ranged->convertTo0to1(lowMidHz));
-        p1->endChangeGesture();
+        //The block engine starts over from this host block, so the queued events have to line up with it
+        performanceFX.syncToHostBlock();
+        modulationMatrix.syncToHostBlock();
+
+        //Anticipative blocks follow the chunk size
+        anticipativeRenderer.reset(blockEngine.getChunkSize((BlockEngine::Mode)blockMode));
     }
 
-    if (auto* p2 = parameters.getParameter("midHighCrossover"))
+    if (anticipative != activeAnticipative.load(std::memory_order_relaxed))
     {
-        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p2);
-        jassert(ranged);
-
-        p2->beginChangeGesture();
-        p2->setValueNotifyingHost(ranged->convertTo0to1(midHighHz));
-        p2->endChangeGesture();
+        //A block still with the render thread is left to it (the direct path keeps off the hosted plugins
+        //and the workers until it is done), and the host has to hear about the extra block of latency
+        anticipativeRenderer.reset(blockEngine.getChunkSize((BlockEngine::Mode)blockMode));
+        activeAnticipative.store(anticipative, std::memory_order_relaxed);
+        triggerAsyncUpdate();
     }
-	updateBandFilterCutoffs();
-}
 
+	//The DSP chain only ever sees chunks the block engine hands out
+    //Views of the main and sidechain channels of each chunk (the sidechain view is empty without the bus)
+    const auto hasSidechain = getBusCount(true) > 1;
 
+    blockEngine.process(buffer, (BlockEngine::Mode)blockMode,
+        [this, hasSidechain](juce::AudioBuffer<float>& chunk)
+        {
+            auto main = getBusBuffer(chunk, false, 0);
 
-//Pitch Dependent Processing MIDI
-void XPulseAudioProcessor::pitchDependent(juce::MidiBuffer& midiMessages) {
-	juce::MidiBuffer lowMidi, midMidi, highMidi;
-    
-    for (const auto metadata : midiMessages) {
-        const auto msg = metadata.getMessage();
-        if (msg.isNoteOnOrOff()) {
-            int note = msg.getNoteNumber();
-            if (note < 48) // Example: C2 and below = Low band
-                lowMidi.addEvent(msg, metadata.samplePosition);
-            else if (note < 78) // Example: C2-E5 = Mid band
-                midMidi.addEvent(msg, metadata.samplePosition);
-            else // F5 and above = High band
-                highMidi.addEvent(msg, metadata.samplePosition);
-        }
-        else {
-            // Non-note messages go to all bands, or handle as needed
-            lowMidi.addEvent(msg, metadata.samplePosition);
-            midMidi.addEvent(msg, metadata.samplePosition);
-            highMidi.addEvent(msg, metadata.samplePosition);
-        }
-    }
+            if (hasSidechain)
+                pitchDependent(main, getBusBuffer(chunk, true, 1));
+            else
+                pitchDependent(main, juce::AudioBuffer<float>());
+        });
+}
 
-	//Process each band
-	processLowBand(lowMidi);
-    processMidBand(midMidi);
-    processHighBand(highMidi);
+//MIDI Processing Function
+void XPulseAudioProcessor::processMidi(juce::MidiBuffer& midiMessages) {
+	//Performance FX trigger notes are queued here and applied at their exact sample when their chunk runs
+    performanceFX.handleMidi(midiMessages, getTransport(), getPerformanceMidiChannel());
 
-	midiMessages.clear();
-    midiMessages.addEvents(lowMidi, 0, -1, 0);
-    midiMessages.addEvents(midMidi, 0, -1, 0);
-    midiMessages.addEvents(highMidi, 0, -1, 0);
-}
-void XPulseAudioProcessor::processLowBand(juce::MidiBuffer& midiMessages) {
-	float totalVelocity = 0.0f;
-    int length = 0;
-    for (const auto metadata : midiMessages) {
-        const auto msg = metadata.getMessage();
-        if (msg.isNoteOn()) {
-			//Multipied by 127 to convert from 0.0-1.0 to 0-127 MIDI velocity range
-			float velocity = msg.getVelocity() * 127;
-			totalVelocity += velocity;
-            length += 1;
-        }
-        else {
-            // Non-note and Non-note on messages remain unchanged
-            midiMessages.addEvent(msg, metadata.samplePosition);
-        }
-	}
-    if (length > 0) {
-        lowBandVelocity = int(totalVelocity / length);
-    }
+	//Modulation sources follow every other channel the same way
+    modulationMatrix.handleMidi(midiMessages, getPerformanceMidiChannel());
 
-	//Here I will check Parameters For Velocity Based FX Modulation
-	//This will be based on User Parameters set in the GUI
-    
-    //Reverb:
-	//This will work by modyfing th Gain value for the wet signal based on the average velocity of the notes in the band
-	//The Dry signal will remain unchanged
-}
-void XPulseAudioProcessor::processMidBand(juce::MidiBuffer& midiMessages) {
-    float totalVelocity = 0.0f;
-    int length = 0;
-    for (const auto metadata : midiMessages) {
-        const auto msg = metadata.getMessage();
-        // Example: Transpose down an octave for low band
-        if (msg.isNoteOn()) {
-            //Multipied by 127 to convert from 0.0-1.0 to 0-127 MIDI velocity range
-            float velocity = msg.getVelocity() * 127;
-            totalVelocity += velocity;
-            length += 1;
-        }
-        else {
-            // Non-note messages and Non-note onremain unchanged
-            midiMessages.addEvent(msg, metadata.samplePosition);
-        }
-    }
-    if(length > 0) {
-        midBandVelocity = int(totalVelocity / length);
-    }
-    //Here I will check Parameters For Velocity Based FX Modulation
-    //This will be based on User Parameters set in the GUI
-       
-    //Reverb:
-    //This will work by modyfing th Gain value for the wet signal based on the average velocity of the notes in the band
-    //The Dry signal will remain unchanged
+	//Tracks the per-band velocities the reverbs are modulated by
+    pitchDependent(midiMessages);
 }
-void XPulseAudioProcessor::processHighBand(juce::MidiBuffer& midiMessages) {
-    float totalVelocity = 0.0f;
-    int length = 0;
-    for (const auto metadata : midiMessages) {
-        const auto msg = metadata.getMessage();
-        // Example: Transpose down an octave for low band
-        if (msg.isNoteOn()) {
-            //Multipied by 127 to convert from 0.0-1.0 to 0-127 MIDI velocity range
-            float velocity = msg.getVelocity() * 127;
-            totalVelocity += velocity;
-            length += 1;
-        }
-        else {
-            // Non-note and Non=note on messages remain unchanged
-            midiMessages.addEvent(msg, metadata.samplePosition);
+
+PerformanceFX::Transport XPulseAudioProcessor::getTransport() {
+    PerformanceFX::Transport transport;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (const auto position = playHead->getPosition())
+        {
+            if (const auto bpm = position->getBpm())
+                transport.bpm = *bpm;
+
+            //Repeats only lock to the beat grid while the host is playing
+            const auto ppq = position->getPpqPosition();
+            if (ppq && position->getIsPlaying())
+            {
+                transport.ppqPosition = *ppq;
+                transport.hasPosition = true;
+            }
         }
     }
-    if (length > 0) {
-        highBandVelocity = int(totalVelocity / length);
-    }
-    //Here I will check Parameters For Velocity Based FX Modulation
-    //This will be based on User Parameters set in the GUI
 
-    //Reverb:
-    //This will work by modyfing th Gain value for the wet signal based on the average velocity of the notes in the band
-    //The Dry signal will remain unchanged
+    return transport;
 }
-#pragma endregion
-
-#pragma region PrepareToPlayFuncions
-void XPulseAudioProcessor::prepareGainProcessor(const juce::dsp::ProcessSpec& spec) {
 
-    midGainProcessor.prepare(spec);
-    lowGainProcessor.prepare(spec);
-    highGainProcessor.prepare(spec);
-    midGainProcessor.reset();
-    lowGainProcessor.reset();
-    highGainProcessor.reset();
+int XPulseAudioProcessor::getPerformanceMidiChannel() const {
+    return juce::jlimit(1, 16, (int)boundParameters.performanceMidiChannel->load(std::memory_order_relaxed));
 }
 
-void XPulseAudioProcessor::prepareBandFilters(const juce::dsp::ProcessSpec& spec)
-{
-    currentSampleRate = spec.sampleRate;
-
-    // 1) set initial states FIRST (non-null)
-    lowBand.state = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, 250.0f);
-
-    auto& midHP = midBand.get<0>();
-    auto& midLP = midBand.get<1>();
-    midHP.state = juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, 250.0f);
-    midLP.state = juce::dsp::IIR::Coefficients<float>::makeLowPass(spec.sampleRate, 4000.0f);
+#pragma region PitchDependentProcessing
+//Pitch-Dependent Processing Function Audio
 
-    highBand.state = juce::dsp::IIR::Coefficients<float>::makeHighPass(spec.sampleRate, 4000.0f);
+void XPulseAudioProcessor::pitchDependent(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain) {
+    const auto numBands = getNumBands();
+    const auto numCh = buffer.getNumChannels();
+    const auto numSamples = buffer.getNumSamples();
 
-    // 2) now prepare
-    lowBand.prepare(spec);
-    midBand.prepare(spec);
-    highBand.prepare(spec);
+	//Band/ramp buffers were sized for the largest chunk in prepareToPlay, only numSamples of them are used
 
-    // 3) now reset
-    lowBand.reset();
-    midBand.reset();
-    highBand.reset();
-}
+    //MIDI modulation offsets for this chunk, moving at the exact samples of the events
+    ModulationMatrix::Route routes[ModulationMatrix::kMaxRoutes];
+    modulationMatrix.process(routes, prepareModulationRoutes(routes), numSamples);
 
+    //The splitters ramp towards the latest crossover targets themselves
+    pushCrossoverTargets(numBands);
 
-void XPulseAudioProcessor::updateBandFilterCutoffs()
-{
-    if (currentSampleRate <= 0.0)
+    const auto mode = (int)boundParameters.crossoverMode->load(std::memory_order_relaxed);
+    if (mode != activeCrossoverMode.load(std::memory_order_relaxed))
     {
-        DBG("[XPulse] currentSampleRate is invalid: " + juce::String(currentSampleRate));
-        return;
+        //Start the newly selected path from clean state and let the host know about the latency change
+        if (mode == linearPhaseMode)
+            linearPhaseSplitter.reset();
+        else
+            bandSplitter.reset();
+
+        activeCrossoverMode.store(mode, std::memory_order_relaxed);
+        triggerAsyncUpdate();
     }
 
-    auto* pLo = parameters.getRawParameterValue("lowMidCrossover");
-    auto* pHi = parameters.getRawParameterValue("midHighCrossover");
-
+	//Band gains + which bands feed hosted plugins
+    BandSplitter::BandMix mix;
+    prepareBandMix(mix, numBands, numSamples);
 
-    if (pLo == nullptr || pHi == nullptr)
-    {
-        DBG("[XPulse] Crossover parameter pointers are null");
-        return;
-    }
+	//Bands with dynamics are held out of the split's mix and added back after the dynamics stage
+    BandDynamics::BandSettings dynamicsSettings[kMaxBands];
+    bool dynamicsBands[kMaxBands] = {};
+    const auto lookahead = prepareDynamics(dynamicsSettings, dynamicsBands, mix, numBands);
 
-    float lo = *pLo;
-    float hi = *pHi;
+	//While any band morphs, every band goes through the (delaying) morph stage
+    SpectralMorph::BandSettings morphSettings[kMaxBands];
+    const auto morphing = prepareMorph(morphSettings, mix, numBands);
 
-   
-    // Clamp to safe range AND nyquist-safe range
-    const float nyquistSafe = (float)(0.49 * currentSampleRate);
-    lo = juce::jlimit(20.0f, nyquistSafe, lo);
-    hi = juce::jlimit(20.0f, nyquistSafe, hi);
+	//Textured bands are captured from the bands buffer, so they have to be written there
+    TextureBlend::BandSettings textureSettings[kMaxBands];
+    bool textureBands[kMaxBands] = {};
+    const auto texturing = prepareTextures(textureSettings, textureBands, mix, numBands);
 
-    // enforce ordering + gap
-    const float minGapHz = 10.0f;
-    if (hi < lo + minGapHz) hi = juce::jmin(nyquistSafe, lo + minGapHz);
+	//Armed bands are recorded for the performance FX, the ones playing an effect are held out of the mix
+    PerformanceFX::Settings performanceSettings;
+    bool armedBands[kMaxBands] = {};
+    const auto performing = preparePerformance(performanceSettings, armedBands, mix, numBands, numSamples);
 
-    // state pointers must exist
-    auto& midHP = midBand.get<0>();
-    auto& midLP = midBand.get<1>();
+	//Reverb wet levels (velocity modulated), flags the bands each active reverb listens to
+    float reverbWet[BandReverb::kNumSlots];
+    prepareReverbs(reverbWet, mix, numBands);
 
-    if (lowBand.state == nullptr || midHP.state == nullptr || midLP.state == nullptr || highBand.state == nullptr)
+    //Split, apply the band gains and mix back into the main buffer
+    //The IIR path does all of it in one pass per tile, without writing the bands out
+    if (mode == linearPhaseMode)
     {
-        DBG("[XPulse] One or more filter state pointers are null!");
-        DBG("  lowBand.state: " + juce::String::toHexString((juce::uint64)(uintptr_t)lowBand.state.get()));
-        DBG("  midHP.state: " + juce::String::toHexString((juce::uint64)(uintptr_t)midHP.state.get()));
-        DBG("  midLP.state: " + juce::String::toHexString((juce::uint64)(uintptr_t)midLP.state.get()));
-        DBG("  highBand.state: " + juce::String::toHexString((juce::uint64)(uintptr_t)highBand.state.get()));
-        return;
+        linearPhaseSplitter.process(buffer, bandBuffers, numBands, numSamples);
+        mixBands(buffer, mix, numBands, numSamples);
+    }
+    else
+    {
+        bandSplitter.process(buffer, buffer, bandBuffers, mix, numBands, numSamples);
     }
 
-    DBG("[XPulse] updateBandFilterCutoffs: sampleRate=" + juce::String(currentSampleRate) + ", lo=" + juce::String(lo) + ", hi=" + juce::String(hi));
-
-    // IMPORTANT: swap pointer, don't mutate *state in place
-    lowBand.state = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, lo);
-    midHP.state = juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSampleRate, lo);
-    midLP.state = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, hi);
-    highBand.state = juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSampleRate, hi);
+    //Per-band compressor/expander on the held-out bands
+    if (std::find(dynamicsBands, dynamicsBands + numBands, true) != dynamicsBands + numBands)
+        bandDynamics.process(bandBuffers, dynamicsSettings, dynamicsBands, numBands, numCh, numSamples,
+            boundParameters.dynamicsLink->load(std::memory_order_relaxed) >= 0.5f, lookahead);
+
+    //Spectral morph after the dynamics
+    if (morphing)
+        spectralMorph.process(bandBuffers, sidechain, morphSettings, numBands, numCh, numSamples,
+            (int)boundParameters.morphFftSize->load(std::memory_order_relaxed),
+            (int)boundParameters.morphHop->load(std::memory_order_relaxed));
+
+    //Repeat / reverse / tape stop replace the engaged bands before they are mixed back in
+    //(with nothing armed the trigger clock still has to keep up with the host)
+    if (performing)
+        performanceFX.process(bandBuffers, armedBands, performanceSettings, numBands, numCh, numSamples);
+    else
+        performanceFX.skip(numSamples);
+
+    //Serial insert chains, in place on their bands (the mix waits for the slowest one)
+    processInserts(bandBuffers, buffer, mix, numBands, numCh, numSamples);
+
+    //Mix the held-out bands back in
+    for (int band = 0; band < numBands; ++band)
+        if (mix.excludeFromMix[band])
+            for (int ch = 0; ch < numCh; ++ch)
+                buffer.addFrom(ch, 0, bandBuffers, band * numCh + ch, 0, numSamples);
+
+    //Grain textures add their wet signal on top of the mix
+    if (texturing)
+        textureBlend.process(bandBuffers, buffer, textureSettings, textureBands, numBands, numCh, numSamples);
+
+    //Native reverbs add their wet signal on top of the mix
+    processReverbs(buffer, reverbWet, numBands, numCh, numSamples);
+
+    //Runs sends into Hosted Plugins (returns are added to the mix)
+    processHostedSends(bandBuffers, buffer, mix, numBands, numCh, numSamples);
 }
 
+void XPulseAudioProcessor::prepareBandMix(BandSplitter::BandMix& mix, int numBands, int numSamples) {
+    for (int band = 0; band < numBands; ++band)
+    {
+        //Gain: a per-sample ramp only while the parameter is moving
+        auto& gain = bandGains[band];
+        gain.setTargetValue(boundParameters.bandGain[band]->load(std::memory_order_relaxed));
 
+        //A modulated gain always needs the ramp
+        const auto* gainModulation = modulationMatrix.getRamp(ModulationMatrix::gainDestination(band));
 
-#pragma endregion
-
-#pragma region HostedPluginSends
-void XPulseAudioProcessor::processHostedSends(juce::AudioBuffer<float>& low,
-    juce::AudioBuffer<float>& mid,
-    juce::AudioBuffer<float>& high)
-{
-    juce::MidiBuffer emptyMidi;
+        if (gain.isSmoothing() || gainModulation != nullptr)
+        {
+            auto* ramp = gainRamps.getWritePointer(band);
+            gain.fillRamp(ramp, numSamples);
 
-    const auto numCh = low.getNumChannels();
-    const auto numSamp = low.getNumSamples();
+            if (gainModulation != nullptr)
+                addModulation(ramp, gainModulation, numSamples);
 
-    // Each slot can route to an arbitrary hosted instance.
-    // bandPluginInstanceId[3][3], bandSendAmount[3][3], bandReturnAmount[3][3]
-    static constexpr int kNumBands = 3;
-    static constexpr int kNumSlots = 3;
+            mix.gainRamp[band] = ramp;
+        }
+        else
+        {
+            mix.gain[band] = gain.getCurrentValue();
+        }
 
-    // Gather unique instance IDs across all band/slot routes
-    PluginPool::InstanceId usedIds[kNumBands * kNumSlots] = {};
-    int numUsed = 0;
+        //Only bands routed to a hosted plugin need a copy of their own
+        //(even at zero send, so the plugin keeps running and its tail rings out)
+        if (activeSchedule != nullptr && activeSchedule->isBandRouted(band))
+            mix.writeBand[band] = true;
 
-    auto pushUnique = [&](PluginPool::InstanceId id)
+        //Insert chains work on the band itself, so it is held out of the mix until they're done
+        if (activeSchedule != nullptr && activeSchedule->hasInserts(band))
         {
-            if (id == 0) return;
+            mix.writeBand[band] = true;
+            mix.excludeFromMix[band] = true;
+        }
+    }
+}
 
-            for (int i = 0; i < numUsed; ++i)
-                if (usedIds[i] == id)
-                    return;
+bool XPulseAudioProcessor::prepareDynamics(BandDynamics::BandSettings* settings, bool* dynamicsBands,
+    BandSplitter::BandMix& mix, int numBands) {
+    const auto lookahead = boundParameters.dynamicsLookahead->load(std::memory_order_relaxed) >= 0.5f;
+    if (lookahead != activeLookahead.load(std::memory_order_relaxed))
+    {
+        //Lookahead delays the whole band path, so the host has to hear about it
+        activeLookahead.store(lookahead, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
 
-            usedIds[numUsed++] = id;
-        };
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& s = settings[band];
+        s.mode = (int)boundParameters.dynamicsMode[band]->load(std::memory_order_relaxed);
+        s.thresholdDb = boundParameters.dynamicsThreshold[band]->load(std::memory_order_relaxed);
+        s.ratio = boundParameters.dynamicsRatio[band]->load(std::memory_order_relaxed);
+        s.attackMs = boundParameters.dynamicsAttack[band]->load(std::memory_order_relaxed);
+        s.releaseMs = boundParameters.dynamicsRelease[band]->load(std::memory_order_relaxed);
+        s.makeupDb = boundParameters.dynamicsMakeup[band]->load(std::memory_order_relaxed);
+
+        //With lookahead every band has to go through the (delaying) dynamics stage to stay aligned
+        dynamicsBands[band] = lookahead || s.mode != BandDynamics::off;
+
+        if (dynamicsBands[band])
+        {
+            mix.writeBand[band] = true;
+            mix.excludeFromMix[band] = true;
+        }
+    }
 
-    for (int band = 0; band < kNumBands; ++band)
-        for (int slot = 0; slot < kNumSlots; ++slot)
-            pushUnique((PluginPool::InstanceId)bandPluginInstanceId[band][slot].load(std::memory_order_relaxed));
+    return lookahead;
+}
 
-    // For each unique hosted instance, sum all sends targeting it, process once, then return to all targets.
-    for (int u = 0; u < numUsed; ++u)
-    {
-        const auto id = usedIds[u];
+bool XPulseAudioProcessor::isMorphing(int numBands) const {
+    for (int band = 0; band < numBands; ++band)
+        if ((int)boundParameters.morphTarget[band]->load(std::memory_order_relaxed) != 0)
+            return true;
 
-        auto* plugin = hostProcessor_.getPool().getInstanceForAudio(id);
-        if (!plugin)
-            continue;
+    return false;
+}
 
-        auxBuffer.setSize(numCh, numSamp, false, false, true);
-        auxBuffer.clear();
+bool XPulseAudioProcessor::prepareMorph(SpectralMorph::BandSettings* settings, BandSplitter::BandMix& mix, int numBands) {
+    const auto morphing = isMorphing(numBands);
+    const auto latency = morphing
+        ? SpectralMorph::getLatencySamples((int)boundParameters.morphFftSize->load(std::memory_order_relaxed))
+        : 0;
 
-        // Sum sends from any band/slot that routes to this instance id
-        auto sumSendFrom = [&](int bandIndex, int slotIndex, juce::AudioBuffer<float>& bandBuf)
+    if (latency != activeMorphLatency.load(std::memory_order_relaxed))
+    {
+        //The stage delays the whole band path by one frame, so the host has to hear about it.
+        //Coming back on, it starts from silence rather than from whatever it held when it stopped
+        if (morphing && activeMorphLatency.load(std::memory_order_relaxed) == 0)
+            spectralMorph.reset();
+
+        activeMorphLatency.store(latency, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
+
+    if (!morphing)
+        return false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        //Choice index: 0 = Off, 1..kMaxBands = a band, then the sidechain
+        const auto choice = (int)boundParameters.morphTarget[band]->load(std::memory_order_relaxed);
+        settings[band].target = choice == 0 ? SpectralMorph::noTarget
+            : choice > kMaxBands ? SpectralMorph::sidechainTarget
+            : choice - 1;
+        settings[band].amount = boundParameters.morphAmount[band]->load(std::memory_order_relaxed);
+
+        //Every band is delayed by the stage, so all of them are held out of the split's mix
+        mix.writeBand[band] = true;
+        mix.excludeFromMix[band] = true;
+    }
+
+    return true;
+}
+
+bool XPulseAudioProcessor::prepareTextures(TextureBlend::BandSettings* settings, bool* textureBands,
+    BandSplitter::BandMix& mix, int numBands) {
+    bool any = false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& s = settings[band];
+        s.mix = boundParameters.textureMix[band]->load(std::memory_order_relaxed);
+
+        //A modulated mix that can't rise above zero this chunk is just off
+        const auto destination = ModulationMatrix::textureMixDestination(band);
+        if (modulationMatrix.getRamp(destination) != nullptr)
+        {
+            if (s.mix + modulationMatrix.getMaximum(destination) > 0.0f)
+                s.mixOffsets = modulationMatrix.getRamp(destination);
+            else
+                s.mix = 0.0f;
+        }
+
+        //Keeps running at zero mix until the last grains have finished
+        textureBands[band] = textureBlend.isActive(band, s.mix);
+        if (!textureBands[band])
+            continue;
+
+        s.grainMs = boundParameters.textureSize[band]->load(std::memory_order_relaxed);
+        s.density = boundParameters.textureDensity[band]->load(std::memory_order_relaxed);
+        s.pitch = boundParameters.texturePitch[band]->load(std::memory_order_relaxed);
+        s.sprayMs = boundParameters.textureSpray[band]->load(std::memory_order_relaxed);
+        s.spread = boundParameters.textureSpread[band]->load(std::memory_order_relaxed);
+
+        mix.writeBand[band] = true;
+        any = true;
+    }
+
+    return any;
+}
+
+int XPulseAudioProcessor::prepareModulationRoutes(ModulationMatrix::Route* routes) {
+    //Flat copy of the routes that are switched on (source choice 0 = Off)
+    int numRoutes = 0;
+
+    for (int route = 0; route < ModulationMatrix::kMaxRoutes; ++route)
+    {
+        const auto source = (int)boundParameters.modulationSource[route]->load(std::memory_order_relaxed) - 1;
+        const auto destination = (int)boundParameters.modulationDestination[route]->load(std::memory_order_relaxed);
+        const auto depth = boundParameters.modulationDepth[route]->load(std::memory_order_relaxed);
+
+        if (source < 0 || source >= ModulationMatrix::kNumSources
+         || destination < 0 || destination >= ModulationMatrix::kNumDestinations || depth == 0.0f)
+            continue;
+
+        routes[numRoutes++] = { source, destination, depth };
+    }
+
+    return numRoutes;
+}
+
+void XPulseAudioProcessor::addModulation(float* values, const float* offsets, int numSamples) {
+    juce::FloatVectorOperations::add(values, offsets, numSamples);
+    juce::FloatVectorOperations::clip(values, values, 0.0f, 1.0f, numSamples);
+}
+
+bool XPulseAudioProcessor::preparePerformance(PerformanceFX::Settings& settings, bool* armedBands,
+    BandSplitter::BandMix& mix, int numBands, int numSamples) {
+    //Reverse length choice: 1/4, 1/2 or 1 beat
+    const auto reverseChoice = juce::jlimit(0, 2, (int)boundParameters.performanceReverseLength->load(std::memory_order_relaxed));
+    settings.reverseBeats = 0.25 * (1 << reverseChoice);
+    settings.tapeStopBeats = boundParameters.performanceTapeStop->load(std::memory_order_relaxed);
+
+    const auto triggering = performanceFX.hasTriggerWithin(numSamples);
+    bool any = false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        armedBands[band] = boundParameters.performanceArm[band]->load(std::memory_order_relaxed) >= 0.5f;
+
+        //A band that was disarmed mid-effect still has to fade back to live
+        const auto engaged = performanceFX.isEngaged(band);
+        if (!armedBands[band] && !engaged)
+            continue;
+
+        //Armed bands are recorded from the bands buffer, so they have to be written there
+        mix.writeBand[band] = true;
+
+        //Only a band that plays (or may start playing) an effect this chunk replaces its own signal
+        if (engaged || triggering)
+            mix.excludeFromMix[band] = true;
+
+        any = true;
+    }
+
+    return any;
+}
+
+void XPulseAudioProcessor::getReverbBands(int slot, int numBands, int& firstBand, int& lastBand) {
+    //Low = bottom band, high = top band, mid = everything in between (nothing with two bands)
+    if (slot == 0) { firstBand = 0; lastBand = 0; }
+    else if (slot == BandReverb::kNumSlots - 1) { firstBand = numBands - 1; lastBand = numBands - 1; }
+    else { firstBand = 1; lastBand = numBands - 2; }
+}
+
+void XPulseAudioProcessor::prepareReverbs(float* wet, BandSplitter::BandMix& mix, int numBands) {
+    //The wet level follows the average note-on velocity of the slot's band (unmodulated until notes arrive)
+    const int velocities[BandReverb::kNumSlots] = { lowBandVelocity, midBandVelocity, highBandVelocity };
+
+    for (int slot = 0; slot < BandReverb::kNumSlots; ++slot)
+    {
+        const auto velocityScale = velocities[slot] > 0 ? juce::jmin(1.0f, velocities[slot] / 127.0f) : 1.0f;
+        wet[slot] = boundParameters.reverbMaster[slot]->load(std::memory_order_relaxed) * velocityScale;
+
+        //Matrix modulation rides on top (see processReverbs)
+        if (!bandReverb.isActive(slot, wet[slot] + modulationMatrix.getMaximum(ModulationMatrix::reverbWetDestination(slot))))
+            continue;
+
+        int first, last;
+        getReverbBands(slot, numBands, first, last);
+
+        for (int band = first; band <= last; ++band)
+            mix.writeBand[band] = true;
+    }
+}
+
+void XPulseAudioProcessor::processReverbs(juce::AudioBuffer<float>& output, const float* wet, int numBands, int numCh, int numSamples) {
+    juce::AudioBuffer<float> input(reverbInput.getArrayOfWritePointers(), numCh, numSamples);
+
+    for (int slot = 0; slot < BandReverb::kNumSlots; ++slot)
+    {
+        const auto destination = ModulationMatrix::reverbWetDestination(slot);
+        if (!bandReverb.isActive(slot, wet[slot] + modulationMatrix.getMaximum(destination)))
+            continue;
+
+        int first, last;
+        getReverbBands(slot, numBands, first, last);
+
+        //Sum of the slot's bands (post gain and dynamics)
+        input.clear();
+        for (int band = first; band <= last; ++band)
+            for (int ch = 0; ch < numCh; ++ch)
+                input.addFrom(ch, 0, bandBuffers, band * numCh + ch, 0, numSamples);
+
+        const auto preset = (int)boundParameters.reverbPreset[slot]->load(std::memory_order_relaxed);
+        bandReverb.process(slot, input, output, preset, wet[slot], numSamples, modulationMatrix.getRamp(destination));
+    }
+}
+
+void XPulseAudioProcessor::mixBands(juce::AudioBuffer<float>& output, const BandSplitter::BandMix& mix, int numBands, int numSamples) {
+    //Gain + mix in one pass per band for the block-based (linear phase) path
+    const auto numCh = output.getNumChannels();
+
+    //The first band that is summed overwrites the output instead of adding to it
+    bool first = true;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto* ramp = mix.gainRamp[band];
+        const auto sum = !mix.excludeFromMix[band];
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto* out = output.getWritePointer(ch);
+            auto* data = bandBuffers.getWritePointer(band * numCh + ch);
+
+            //Bands feeding hosted plugins (or the dynamics) keep their gained signal
+            if (mix.writeBand[band])
+            {
+                if (ramp != nullptr) juce::FloatVectorOperations::multiply(data, ramp, numSamples);
+                else juce::FloatVectorOperations::multiply(data, mix.gain[band], numSamples);
+
+                if (!sum) continue;
+
+                if (first) juce::FloatVectorOperations::copy(out, data, numSamples);
+                else juce::FloatVectorOperations::add(out, data, numSamples);
+            }
+            else if (ramp != nullptr)
+            {
+                if (first) juce::FloatVectorOperations::multiply(out, data, ramp, numSamples);
+                else juce::FloatVectorOperations::addWithMultiply(out, data, ramp, numSamples);
+            }
+            else
             {
-                const auto routedId =
-                    (PluginPool::InstanceId)bandPluginInstanceId[bandIndex][slotIndex].load(std::memory_order_relaxed);
+                if (first) juce::FloatVectorOperations::copyWithMultiply(out, data, mix.gain[band], numSamples);
+                else juce::FloatVectorOperations::addWithMultiply(out, data, mix.gain[band], numSamples);
+            }
+        }
+
+        first = first && !sum;
+    }
+
+    //Every band was held back for the dynamics
+    if (first)
+        output.clear(0, numSamples);
+}
+
+juce::String XPulseAudioProcessor::getBandGainParamId(int band)
+{
+    static const char* const firstBands[] = { "lowGain", "midGain", "highGain" };
+    return band < 3 ? juce::String(firstBands[band]) : "band" + juce::String(band + 1) + "Gain";
+}
+
+juce::String XPulseAudioProcessor::getDynamicsParamId(int band, const char* name)
+{
+    return "band" + juce::String(band + 1) + "Dyn" + name;
+}
+
+juce::String XPulseAudioProcessor::getReverbParamId(int slot, const char* name)
+{
+    static const char* const slotPrefixes[] = { "low", "mid", "high" };
+    return juce::String(slotPrefixes[slot]) + "Reverb" + name;
+}
+
+juce::String XPulseAudioProcessor::getMorphParamId(int band, const char* name)
+{
+    return "band" + juce::String(band + 1) + "Morph" + name;
+}
+
+juce::String XPulseAudioProcessor::getTextureParamId(int band, const char* name)
+{
+    return "band" + juce::String(band + 1) + "Texture" + name;
+}
+
+juce::String XPulseAudioProcessor::getPerformanceParamId(int band, const char* name)
+{
+    return "band" + juce::String(band + 1) + "Perf" + name;
+}
+
+juce::String XPulseAudioProcessor::getModulationParamId(int route, const char* name)
+{
+    return "mod" + juce::String(route + 1) + name;
+}
+
+juce::String XPulseAudioProcessor::getCrossoverParamId(int crossover)
+{
+    static const char* const firstCrossovers[] = { "lowMidCrossover", "midHighCrossover" };
+    return crossover < 2 ? juce::String(firstCrossovers[crossover]) : "crossover" + juce::String(crossover + 1);
+}
+
+int XPulseAudioProcessor::getNumBands() const
+{
+    return juce::jlimit(kMinBands, kMaxBands, (int)boundParameters.numBands->load(std::memory_order_relaxed));
+}
+
+void XPulseAudioProcessor::setBandSplits(float lowMidHz, float midHighHz)
+{
+    lowMidHz = juce::jlimit(20.0f, 20000.0f, lowMidHz);
+    midHighHz = juce::jlimit(20.0f, 20000.0f, midHighHz);
+
+    const float minGapHz = 10.0f;
+    if (midHighHz < lowMidHz + minGapHz)
+        midHighHz = lowMidHz + minGapHz;
+
+    if (auto* p1 = parameters.getParameter("lowMidCrossover"))
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p1);
+        jassert(ranged);
+
+        p1->beginChangeGesture();
+        p1->setValueNotifyingHost(ranged->convertTo0to1(lowMidHz));
+        p1->endChangeGesture();
+    }
+
+    if (auto* p2 = parameters.getParameter("midHighCrossover"))
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p2);
+        jassert(ranged);
+
+        p2->beginChangeGesture();
+        p2->setValueNotifyingHost(ranged->convertTo0to1(midHighHz));
+        p2->endChangeGesture();
+    }
+
+    // Nothing else to do here: the audio thread picks the new values up as crossover
+    // targets on its next block and ramps to them (see pushCrossoverTargets)
+}
+
+
+
+//Pitch Dependent Processing MIDI
+void XPulseAudioProcessor::pitchDependent(juce::MidiBuffer& midiMessages) {
+	juce::MidiBuffer lowMidi, midMidi, highMidi;
+    
+    const auto performanceChannel = getPerformanceMidiChannel();
+
+    for (const auto metadata : midiMessages) {
+        const auto msg = metadata.getMessage();
+        //Notes on the performance channel are FX triggers (consumed by the performance FX, not played)
+        if (msg.isNoteOnOrOff() && msg.getChannel() == performanceChannel)
+            continue;
+
+        if (msg.isNoteOnOrOff()) {
+            int note = msg.getNoteNumber();
+            if (note < 48) // Example: C2 and below = Low band
+                lowMidi.addEvent(msg, metadata.samplePosition);
+            else if (note < 78) // Example: C2-E5 = Mid band
+                midMidi.addEvent(msg, metadata.samplePosition);
+            else // F5 and above = High band
+                highMidi.addEvent(msg, metadata.samplePosition);
+        }
+        else {
+            // Non-note messages go to all bands, or handle as needed
+            lowMidi.addEvent(msg, metadata.samplePosition);
+            midMidi.addEvent(msg, metadata.samplePosition);
+            highMidi.addEvent(msg, metadata.samplePosition);
+        }
+    }
+
+	//Process each band
+	processLowBand(lowMidi);
+    processMidBand(midMidi);
+    processHighBand(highMidi);
+
+	midiMessages.clear();
+    midiMessages.addEvents(lowMidi, 0, -1, 0);
+    midiMessages.addEvents(midMidi, 0, -1, 0);
+    midiMessages.addEvents(highMidi, 0, -1, 0);
+}
+void XPulseAudioProcessor::processLowBand(juce::MidiBuffer& midiMessages) {
+	float totalVelocity = 0.0f;
+    int length = 0;
+    for (const auto metadata : midiMessages) {
+        const auto msg = metadata.getMessage();
+        if (msg.isNoteOn()) {
+			//getVelocity() is already in the 0-127 MIDI velocity range
+			float velocity = msg.getVelocity();
+			totalVelocity += velocity;
+            length += 1;
+        }
+        //Other messages are left in the buffer as they are (adding them again while iterating is unsafe)
+	}
+    if (length > 0) {
+        lowBandVelocity = int(totalVelocity / length);
+    }
+
+	//Velocity / note count / aftertouch routes to other band parameters are evaluated sample
+	//accurately per chunk by the modulation matrix (routes are set in the GUI)
+    
+    //Reverb:
+	//The wet gain of the low reverb follows lowBandVelocity (see prepareReverbs), the dry signal is unchanged
+}
+void XPulseAudioProcessor::processMidBand(juce::MidiBuffer& midiMessages) {
+    float totalVelocity = 0.0f;
+    int length = 0;
+    for (const auto metadata : midiMessages) {
+        const auto msg = metadata.getMessage();
+        // Example: Transpose down an octave for low band
+        if (msg.isNoteOn()) {
+            //getVelocity() is already in the 0-127 MIDI velocity range
+            float velocity = msg.getVelocity();
+            totalVelocity += velocity;
+            length += 1;
+        }
+        //Other messages are left in the buffer as they are (adding them again while iterating is unsafe)
+    }
+    if(length > 0) {
+        midBandVelocity = int(totalVelocity / length);
+    }
+    //Velocity / note count / aftertouch routes to other band parameters are evaluated sample
+    //accurately per chunk by the modulation matrix (routes are set in the GUI)
+       
+    //Reverb:
+    //The wet gain of the mid reverb follows midBandVelocity (see prepareReverbs), the dry signal is unchanged
+}
+void XPulseAudioProcessor::processHighBand(juce::MidiBuffer& midiMessages) {
+    float totalVelocity = 0.0f;
+    int length = 0;
+    for (const auto metadata : midiMessages) {
+        const auto msg = metadata.getMessage();
+        // Example: Transpose down an octave for low band
+        if (msg.isNoteOn()) {
+            //getVelocity() is already in the 0-127 MIDI velocity range
+            float velocity = msg.getVelocity();
+            totalVelocity += velocity;
+            length += 1;
+        }
+        //Other messages are left in the buffer as they are (adding them again while iterating is unsafe)
+    }
+    if (length > 0) {
+        highBandVelocity = int(totalVelocity / length);
+    }
+    //Velocity / note count / aftertouch routes to other band parameters are evaluated sample
+    //accurately per chunk by the modulation matrix (routes are set in the GUI)
+
+    //Reverb:
+    //The wet gain of the high reverb follows highBandVelocity (see prepareReverbs), the dry signal is unchanged
+}
+#pragma endregion
+
+#pragma region PrepareToPlayFuncions
+void XPulseAudioProcessor::prepareGainProcessor(const juce::dsp::ProcessSpec& spec) {
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        bandGains[band].reset(spec.sampleRate, kGainRampSeconds);
+        bandGains[band].setCurrentAndTargetValue(boundParameters.bandGain[band]->load(std::memory_order_relaxed));
+    }
+
+    gainRamps.setSize(kMaxBands, (int)spec.maximumBlockSize);
+}
+
+void XPulseAudioProcessor::prepareBandFilters(const juce::dsp::ProcessSpec& spec)
+{
+    currentSampleRate = spec.sampleRate;
+
+    // Publish the current parameter values first so prepare() starts on them without a ramp
+    pushCrossoverTargets(getNumBands());
+    bandSplitter.prepare(spec);
+    linearPhaseSplitter.prepare(spec);
+    bandDynamics.prepare(spec);
+    bandReverb.prepare(spec);
+    spectralMorph.prepare(spec);
+    textureBlend.prepare(spec);
+    performanceFX.prepare(spec);
+    modulationMatrix.prepare(spec);
+    activeLookahead.store(boundParameters.dynamicsLookahead->load(std::memory_order_relaxed) >= 0.5f, std::memory_order_relaxed);
+
+    activeCrossoverMode.store((int)boundParameters.crossoverMode->load(std::memory_order_relaxed), std::memory_order_relaxed);
+    activeMorphLatency.store(isMorphing(getNumBands())
+        ? SpectralMorph::getLatencySamples((int)boundParameters.morphFftSize->load(std::memory_order_relaxed))
+        : 0, std::memory_order_relaxed);
+}
+
+int XPulseAudioProcessor::getCrossoverLatency(int mode) const
+{
+    return mode == linearPhaseMode ? linearPhaseSplitter.getLatencySamples() : 0;
+}
+
+XPulseAudioProcessor::HostedActivity& XPulseAudioProcessor::getHostedActivity(PluginPool::InstanceId id, const PluginPool::InstanceId* usedIds, int numUsed)
+{
+    for (auto& entry : hostedActivity)
+        if (entry.id == id)
+            return entry;
+
+    // Take over an entry whose instance isn't routed any more (there is one entry per possible step)
+    for (auto& entry : hostedActivity)
+    {
+        if (std::find(usedIds, usedIds + numUsed, entry.id) != usedIds + numUsed)
+            continue;
+
+        entry.id = id;
+        entry.activity.reset();
+        entry.averageSeconds = 0.0;
+        return entry;
+    }
+
+    jassertfalse;
+    return hostedActivity[0];
+}
+
+void XPulseAudioProcessor::setBandPluginInstanceId(int band, int slot, uint32_t id, bool releasePrevious)
+{
+    if ((unsigned)band >= kMaxBands || (unsigned)slot >= kNumSlots)
+        return;
+
+    const auto current = bandPluginInstanceId[band][slot].load(std::memory_order_relaxed);
+    if (current == id)
+        return;
+
+    // Swapped again before the last fade was over: its old instance drops out on the spot
+    auto& swap = routeSwaps[band][slot];
+    const auto released = swap.fading ? endSwap(swap) : 0;
+
+    // Nothing runs without audio, so there is nothing to fade
+    if (hostProcessor_.getPool().isAudioRunning())
+        swap = { current, true, releasePrevious };
+
+    bandPluginInstanceId[band][slot].store(id, std::memory_order_relaxed);
+    rebuildRoutingSchedule();
+
+    releaseSwappedOut(released);
+    if (!swap.fading && releasePrevious)
+        releaseSwappedOut(current);
+}
+
+void XPulseAudioProcessor::setBandInsertInstanceId(int band, int position, uint32_t id, bool releasePrevious)
+{
+    if ((unsigned)band >= kMaxBands || (unsigned)position >= kMaxInserts)
+        return;
+
+    const auto current = bandInsertInstanceId[band][position].load(std::memory_order_relaxed);
+    if (current == id)
+        return;
+
+    auto& swap = insertSwaps[band][position];
+    const auto released = swap.fading ? endSwap(swap) : 0;
+
+    // Positions past the chain's length don't run, so they swap straight away
+    if (hostProcessor_.getPool().isAudioRunning() && position < bandInsertLength[band].load(std::memory_order_relaxed))
+        swap = { current, true, releasePrevious };
+
+    bandInsertInstanceId[band][position].store(id, std::memory_order_relaxed);
+    rebuildRoutingSchedule();
+
+    releaseSwappedOut(released);
+    if (!swap.fading && releasePrevious)
+        releaseSwappedOut(current);
+}
+
+void XPulseAudioProcessor::setBandInsertLength(int band, int length)
+{
+    if ((unsigned)band < kMaxBands)
+    {
+        length = juce::jlimit(0, kMaxInserts, length);
+        bandInsertLength[band].store(length, std::memory_order_relaxed);
+
+        // Positions cut off the chain stop running, so their fades would never finish
+        PluginPool::InstanceId released[kMaxInserts] = {};
+        for (int position = length; position < kMaxInserts; ++position)
+            if (insertSwaps[band][position].fading)
+                released[position] = endSwap(insertSwaps[band][position]);
+
+        rebuildRoutingSchedule();
+
+        for (auto id : released)
+            releaseSwappedOut(id);
+    }
+}
+
+PluginPool::InstanceId XPulseAudioProcessor::endSwap(InstanceSwap& swap)
+{
+    const auto released = swap.releasePrevious ? swap.previous : 0;
+    swap = {};
+    return released;
+}
+
+void XPulseAudioProcessor::releaseSwappedOut(PluginPool::InstanceId id)
+{
+    if (id == 0)
+        return;
+
+    // The same instance may have been routed back in (or still fade out elsewhere) meanwhile
+    for (int band = 0; band < kMaxBands; ++band)
+    {
+        for (int slot = 0; slot < kNumSlots; ++slot)
+            if (bandPluginInstanceId[band][slot].load(std::memory_order_relaxed) == id
+                || (routeSwaps[band][slot].fading && routeSwaps[band][slot].previous == id))
+                return;
+
+        for (int position = 0; position < kMaxInserts; ++position)
+            if (bandInsertInstanceId[band][position].load(std::memory_order_relaxed) == id
+                || (insertSwaps[band][position].fading && insertSwaps[band][position].previous == id))
+                return;
+    }
+
+    hostProcessor_.getPool().destroyInstance(id);
+}
+
+int XPulseAudioProcessor::getSwapFadeSamples() const
+{
+    return juce::jmax(1, (int)(boundParameters.swapFade->load(std::memory_order_relaxed) * 0.001 * currentSampleRate));
+}
+
+void XPulseAudioProcessor::syncSwapFade(SwapFade& fade, PluginPool::InstanceId from, PluginPool::InstanceId to)
+{
+    if (fade.from != from || fade.to != to)
+        fade = { from, to, 0, false };
+}
+
+bool XPulseAudioProcessor::advanceSwapFade(SwapFade& fade, int numSamples, int length)
+{
+    fade.position = juce::jmin(length, fade.position + numSamples);
+
+    if (fade.finished || fade.position < length)
+        return false;
+
+    fade.finished = true;
+    return true;
+}
+
+void XPulseAudioProcessor::syncRouteFades(const RoutingGraph::Schedule& schedule)
+{
+    for (const auto& swap : schedule.fades)
+    {
+        const auto route = swap.band * kNumSlots + swap.slot;
+        auto& fade = routeFades[route];
+
+        if (fade.from == swap.from && fade.to == swap.to)
+            continue;
+
+        syncSwapFade(fade, swap.from, swap.to);
 
-                if (routedId != id)
-                    return;
+        // The incoming instance starts on a silent line, whichever one the outgoing one isn't using
+        for (auto line : { route, route + kMaxBands * kNumSlots })
+            if (delayCompensation.getSource(line) != swap.from)
+                delayCompensation.forget(line);
+    }
+}
 
-                const float send =
-                    bandSendAmount[bandIndex][slotIndex].load(std::memory_order_relaxed);
+void XPulseAudioProcessor::advanceRouteFades(const RoutingGraph::Schedule& schedule, int numSamples)
+{
+    const auto length = getSwapFadeSamples();
 
-                if (send <= 0.0001f)
-                    return;
+    for (const auto& swap : schedule.fades)
+    {
+        const auto route = swap.band * kNumSlots + swap.slot;
 
-                for (int ch = 0; ch < numCh; ++ch)
-                    auxBuffer.addFrom(ch, 0, bandBuf, ch, 0, numSamp, send);
-            };
+        if (advanceSwapFade(routeFades[route], numSamples, length))
+        {
+            finishedRouteFades[route].store(packSwap(swap.from, swap.to), std::memory_order_release);
+            triggerAsyncUpdate();
+        }
+    }
+}
 
-        // Low band
-        for (int slot = 0; slot < kNumSlots; ++slot)
-            sumSendFrom(0, slot, low);
+int XPulseAudioProcessor::getReturnLine(const RoutingGraph::Port& port, PluginPool::InstanceId id) const
+{
+    const auto first = port.band * kNumSlots + port.slot;
+    const auto second = first + kMaxBands * kNumSlots;
+
+    if (delayCompensation.getSource(first) == id)
+        return first;
+
+    if (delayCompensation.getSource(second) == id)
+        return second;
+
+    // A new instance takes the line the other side of its fade isn't on
+    const auto& fade = routeFades[first];
+    const auto other = port.fade == RoutingGraph::fadeIn ? fade.from : port.fade == RoutingGraph::fadeOut ? fade.to : 0;
+
+    return other != 0 && delayCompensation.getSource(first) == other ? second : first;
+}
 
-        // Mid band
+void XPulseAudioProcessor::rebuildRoutingSchedule()
+{
+    RoutingGraph::Route routes[kMaxBands * kNumSlots];
+    PluginPool::InstanceId inserts[kMaxBands * kMaxInserts];
+    PluginPool::InstanceId insertPrevious[kMaxBands * kMaxInserts];
+    int insertLengths[kMaxBands];
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
         for (int slot = 0; slot < kNumSlots; ++slot)
-            sumSendFrom(1, slot, mid);
+        {
+            auto& route = routes[band * kNumSlots + slot];
+            route.id = bandPluginInstanceId[band][slot].load(std::memory_order_relaxed);
+            route.send = bandSendAmount[band][slot].load(std::memory_order_relaxed);
+            route.ret = bandReturnAmount[band][slot].load(std::memory_order_relaxed);
+            route.previous = routeSwaps[band][slot].previous;
+            route.fading = routeSwaps[band][slot].fading;
+        }
+
+        for (int position = 0; position < kMaxInserts; ++position)
+        {
+            inserts[band * kMaxInserts + position] = bandInsertInstanceId[band][position].load(std::memory_order_relaxed);
+            insertPrevious[band * kMaxInserts + position] = insertSwaps[band][position].fading ? insertSwaps[band][position].previous : 0;
+        }
+
+        insertLengths[band] = bandInsertLength[band].load(std::memory_order_relaxed);
+    }
+
+    auto schedule = RoutingGraph(routes, kMaxBands, kNumSlots, inserts, insertLengths, kMaxInserts, insertPrevious).compile();
+
+    routingSchedule.store(schedule.get());
+
+    // The audio side may still be on the old one until it passes two quiescent points from here
+    if (publishedSchedule != nullptr)
+        retiredSchedules.push_back({ std::move(publishedSchedule), hostProcessor_.getPool().getQuiescentEpoch() });
+
+    publishedSchedule = std::move(schedule);
+    freeRetiredSchedules();
+}
+
+void XPulseAudioProcessor::freeRetiredSchedules()
+{
+    const auto& pool = hostProcessor_.getPool();
+    const auto epoch = pool.getQuiescentEpoch();
+    const auto running = pool.isAudioRunning();
+
+    retiredSchedules.erase(std::remove_if(retiredSchedules.begin(), retiredSchedules.end(),
+        [&](const RetiredSchedule& retired) { return !running || epoch - retired.epoch >= 2; }), retiredSchedules.end());
+}
+
+int XPulseAudioProcessor::getReportedLatency() const
+{
+    return getCrossoverLatency(activeCrossoverMode.load(std::memory_order_relaxed))
+        + blockEngine.getLatencySamples((BlockEngine::Mode)activeBlockMode.load(std::memory_order_relaxed))
+        + (activeLookahead.load(std::memory_order_relaxed) ? bandDynamics.getLookaheadSamples() : 0)
+        + activeMorphLatency.load(std::memory_order_relaxed)
+        + activeInsertLatency.load(std::memory_order_relaxed)
+        + activeHostedLatency.load(std::memory_order_relaxed)
+        + (activeAnticipative.load(std::memory_order_relaxed)
+            ? blockEngine.getChunkSize((BlockEngine::Mode)activeBlockMode.load(std::memory_order_relaxed))
+            : 0);
+}
+
+void XPulseAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(getReportedLatency());
+    freeRetiredSchedules();
 
-        // High band
+    // Swaps whose fade is over (and still the current one at their route or position) let go of the old instance
+    PluginPool::InstanceId released[kMaxBands * (kNumSlots + kMaxInserts)] = {};
+    int numEnded = 0;
+
+    for (int band = 0; band < kMaxBands; ++band)
+    {
         for (int slot = 0; slot < kNumSlots; ++slot)
-            sumSendFrom(2, slot, high);
+        {
+            const auto finished = finishedRouteFades[band * kNumSlots + slot].exchange(0, std::memory_order_acquire);
+            auto& swap = routeSwaps[band][slot];
+
+            if (finished != 0 && swap.fading
+                && finished == packSwap(swap.previous, bandPluginInstanceId[band][slot].load(std::memory_order_relaxed)))
+                released[numEnded++] = endSwap(swap);
+        }
+
+        // Insert fades are reported by index in the chain, the swap they belong to is found by its instances
+        for (int index = 0; index < kMaxInserts; ++index)
+        {
+            const auto finished = finishedInsertFades[band][index].exchange(0, std::memory_order_acquire);
+            if (finished == 0)
+                continue;
+
+            for (int position = 0; position < kMaxInserts; ++position)
+            {
+                auto& swap = insertSwaps[band][position];
+
+                if (swap.fading
+                    && finished == packSwap(swap.previous, bandInsertInstanceId[band][position].load(std::memory_order_relaxed)))
+                {
+                    released[numEnded++] = endSwap(swap);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (numEnded == 0)
+        return;
+
+    rebuildRoutingSchedule();
+
+    for (int i = 0; i < numEnded; ++i)
+        releaseSwappedOut(released[i]);
+}
+
+
+void XPulseAudioProcessor::pushCrossoverTargets(int numBands)
+{
+    // Called on the audio thread every block: atomic loads and clamping only
+    if (currentSampleRate <= 0.0)
+        return;
+
+    const auto numCrossovers = numBands - 1;
+    const float nyquistSafe = (float)(0.49 * currentSampleRate);
+    const float minGapHz = 10.0f;
 
-        // Process hosted plugin once for this instance id
-        plugin->processBlock(auxBuffer, emptyMidi);
+    float hz[kMaxBands - 1];
+    for (int k = 0; k < numCrossovers; ++k)
+        hz[k] = juce::jlimit(20.0f, nyquistSafe, boundParameters.crossover[k]->load(std::memory_order_relaxed));
 
-        // Return wet back to any band/slot that routes to this instance id
-        auto returnTo = [&](int bandIndex, int slotIndex, juce::AudioBuffer<float>& bandBuf)
+    // The splitters expect ascending crossovers. Each one is clamped between its neighbours rather
+    // than sorted, so a crossover dragged past the next stops at it (the bands keep their order and
+    // their settings), from the bottom up and then back down from the nyquist limit, a gap apart
+    for (int k = 1; k < numCrossovers; ++k)
+        hz[k] = juce::jmax(hz[k], hz[k - 1] + minGapHz);
+
+    hz[numCrossovers - 1] = juce::jmin(hz[numCrossovers - 1], nyquistSafe);
+    for (int k = numCrossovers - 2; k >= 0; --k)
+        hz[k] = juce::jmin(hz[k], hz[k + 1] - minGapHz);
+
+    bandSplitter.setTargetCrossovers(hz, numCrossovers);
+    linearPhaseSplitter.setTargetCrossovers(hz, numCrossovers);
+}
+
+
+
+#pragma endregion
+
+#pragma region HostedPluginSends
+void XPulseAudioProcessor::processInserts(juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+    const BandSplitter::BandMix& mix, int numBands, int numCh, int numSamp)
+{
+    if (activeSchedule == nullptr)
+        return;
+
+    const auto& schedule = *activeSchedule;
+    auto& pool = hostProcessor_.getPool();
+
+    // Chains of the active bands, with the latency each adds up along the way
+    const RoutingGraph::Chain* chains[kMaxBands] = {};
+    int chainLatency[kMaxBands] = {};
+    int numChains = 0;
+    int latency = 0;
+    double estimatedSeconds = 0.0;
+
+    const auto fadeLength = getSwapFadeSamples();
+
+    // Moves a swapped insert's fade on, reporting it once it is over
+    auto advanceInsertFade = [&](int band, int index, PluginPool::InstanceId previous, PluginPool::InstanceId id)
+        {
+            auto& fade = insertFades[band][index];
+            syncSwapFade(fade, previous, id);
+
+            if (advanceSwapFade(fade, numSamp, fadeLength))
+            {
+                finishedInsertFades[band][index].store(packSwap(previous, id), std::memory_order_release);
+                triggerAsyncUpdate();
+            }
+        };
+
+    for (const auto& chain : schedule.chains)
+    {
+        // An inactive band's chain doesn't run, its swaps just finish in the background
+        if (chain.band >= numBands)
+        {
+            for (int i = 0; i < chain.length; ++i)
+                if (const auto previous = schedule.insertPrevious[(size_t)(chain.first + i)])
+                    advanceInsertFade(chain.band, i, previous, schedule.inserts[(size_t)(chain.first + i)]);
+
+            continue;
+        }
+
+        for (int i = 0; i < chain.length; ++i)
+        {
+            // A position fading out of the chain keeps its latency until it is gone
+            const auto id = schedule.inserts[(size_t)(chain.first + i)];
+            const auto previous = schedule.insertPrevious[(size_t)(chain.first + i)];
+            const auto latencyId = id != 0 ? id : previous;
+
+            if (const auto* plugin = pool.getInstanceForAudio(latencyId))
+                chainLatency[chain.band] += pool.getLatencyForAudio(latencyId, *plugin);
+
+            estimatedSeconds += insertActivity[chain.band][i].averageSeconds;
+            if (previous != 0)
+                estimatedSeconds += insertFadeActivity[chain.band][i].averageSeconds;
+        }
+
+        latency = juce::jmax(latency, chainLatency[chain.band]);
+        chains[numChains++] = &chain;
+    }
+
+    latency = juce::jmin(latency, insertCompensation.getMaxDelay());
+    if (latency != activeInsertLatency.load(std::memory_order_relaxed))
+    {
+        activeInsertLatency.store(latency, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
+
+    // A sleeping insert passes the (silent) band straight through, a waking one fades it in
+    auto runInsert = [&](PluginPool::InstanceId id, HostedActivity& entry, juce::AudioBuffer<float>& audio)
+        {
+            HostedJob job;
+            job.plugin = pool.getInstanceForAudio(id);
+            if (job.plugin == nullptr)
+                return;
+
+            // A position that changed instance starts its tracking over
+            if (entry.id != id)
             {
-                const auto routedId =
-                    (PluginPool::InstanceId)bandPluginInstanceId[bandIndex][slotIndex].load(std::memory_order_relaxed);
+                entry.id = id;
+                entry.activity.reset();
+                entry.averageSeconds = 0.0;
+            }
+
+            job.entry = &entry;
+            runHostedInstance(job, audio, true);
+        };
 
-                if (routedId != id)
-                    return;
+    // One job per band: its inserts one after the other, in place, with no aux round trip.
+    // Each chain only touches its own band, its own slice of insertFadeBuffer and its own activity and fade entries
+    auto runChain = [&](int c)
+        {
+            const auto& chain = *chains[c];
+            juce::AudioBuffer<float> band(bands.getArrayOfWritePointers() + chain.band * numCh, numCh, numSamp);
+
+            for (int i = 0; i < chain.length; ++i)
+            {
+                const auto id = schedule.inserts[(size_t)(chain.first + i)];
+                const auto previous = schedule.insertPrevious[(size_t)(chain.first + i)];
+
+                if (previous == 0)
+                {
+                    runInsert(id, insertActivity[chain.band][i], band);
+                    continue;
+                }
+
+                // A swapped position runs the old instance on a copy of the band and crossfades to the new one
+                // (an empty side passes the band through, so inserting and removing fade as well)
+                juce::AudioBuffer<float> old(insertFadeBuffer.getArrayOfWritePointers() + chain.band * numCh, numCh, numSamp);
+                for (int ch = 0; ch < numCh; ++ch)
+                    old.copyFrom(ch, 0, band, ch, 0, numSamp);
 
-                const float ret =
-                    bandReturnAmount[bandIndex][slotIndex].load(std::memory_order_relaxed);
+                runInsert(id, insertActivity[chain.band][i], band);
+                runInsert(previous, insertFadeActivity[chain.band][i], old);
 
-               
-                if (ret <= 0.0001f)
-                    return;
+                auto& fade = insertFades[chain.band][i];
+                syncSwapFade(fade, previous, id);
 
                 for (int ch = 0; ch < numCh; ++ch)
-                    bandBuf.addFrom(ch, 0, auxBuffer, ch, 0, numSamp, ret);
-            };
+                {
+                    auto* out = band.getWritePointer(ch);
+                    const auto* faded = old.getReadPointer(ch);
+
+                    for (int s = 0; s < numSamp; ++s)
+                        out[s] = faded[s] + (out[s] - faded[s]) * getSwapFadeGain(fade, s, fadeLength);
+                }
+
+                advanceInsertFade(chain.band, i, previous, id);
+            }
+        };
+
+    // The render thread has the worker pool in anticipative mode (and for a while after it, until it
+    // is done with its last block), so the chains stay on this thread then
+    if (activeAnticipative.load(std::memory_order_relaxed) || anticipativeRenderer.isRendering())
+    {
+        for (int c = 0; c < numChains; ++c)
+            runChain(c);
+    }
+    else
+    {
+        runHostedJobs(numChains, estimatedSeconds, runChain);
+    }
+
+    // Line everything up with the slowest chain: the mix so far, and every band a later stage reads
+    insertCompensation.processDry(output, numSamp, latency);
+
+    for (int band = 0; band < numBands; ++band)
+        if (mix.writeBand[band])
+            insertCompensation.processInPlace(band, bands.getArrayOfWritePointers() + band * numCh, numCh, numSamp,
+                juce::jmax(0, latency - chainLatency[band]));
+}
+
+void XPulseAudioProcessor::processHostedSends(const juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+    const BandSplitter::BandMix& mix, int numBands, int numCh, int numSamp)
+{
+    // The routing comes from the schedule compiled on the message thread: one step per hosted
+    // instance, with the band/slot sends feeding it and the returns it feeds, amounts included (see RoutingGraph)
+    const auto anticipative = activeAnticipative.load(std::memory_order_relaxed);
+
+    // Delay compensation: the mix so far waits for the slowest routed instance
+    const auto hostedLatency = activeSchedule != nullptr ? getHostedLatency(*activeSchedule) : 0;
+    if (hostedLatency != activeHostedLatency.load(std::memory_order_relaxed))
+    {
+        activeHostedLatency.store(hostedLatency, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+    }
+
+    delayCompensation.processDry(output, numSamp, hostedLatency);
+
+    if (!anticipative && (activeSchedule == nullptr || (activeSchedule->steps.empty() && activeSchedule->fades.empty())))
+        return;
+
+    // Only the bands flagged in the mix were written to bands this block,
+    // so routes from anything else are ignored until the next block picks them up
+    juce::uint32 writtenBands = 0;
+    for (int band = 0; band < numBands; ++band)
+        if (mix.writeBand[band])
+            writtenBands |= 1u << band;
 
-        for (int slot = 0; slot < kNumSlots; ++slot) returnTo(0, slot, low);
-        for (int slot = 0; slot < kNumSlots; ++slot) returnTo(1, slot, mid);
-        for (int slot = 0; slot < kNumSlots; ++slot) returnTo(2, slot, high);
+    // Silent bands have nothing to send (their plugins still run out their tails below)
+    bool bandLive[kMaxBands] = {};
+    for (int band = 0; band < numBands; ++band)
+        bandLive[band] = mix.writeBand[band] && !Silence::isDigitalSilence(bands, band * numCh, numCh, numSamp);
+
+    // Anticipative: the instances run a block later on the render thread (the dry path is delayed to match)
+    if (anticipative)
+    {
+        captureHostedSends(bands, output, writtenBands, bandLive, numCh, numSamp);
+        return;
+    }
+
+    const auto& schedule = *activeSchedule;
+
+    // Anticipative hosting was only just switched off and the render thread is still running the
+    // instances for its last block: this block goes without their returns rather than wait for it
+    if (anticipativeRenderer.isRendering())
+        return;
+
+    // Every instance in a level reads only the finished bands and writes only its own aux channels
+    // (those of its step), so a level runs as one parallel batch
+    HostedJob jobs[kMaxHostedSteps];
+    bool processed[kMaxHostedSteps] = {};
+    int numJobs = 0;
+
+    for (int level = 0; level < schedule.getNumLevels(); ++level)
+    {
+        double estimatedSeconds = 0.0;
+        const auto firstJob = numJobs;
+        numJobs += gatherHostedJobs(schedule, level, writtenBands, jobs + firstJob, estimatedSeconds);
+
+        // Sum all sends targeting one instance into its own aux channels and process it once
+        runHostedJobs(numJobs - firstJob, estimatedSeconds, [&](int j)
+            {
+                const auto& job = jobs[firstJob + j];
+
+                // The plugins get a view of exactly this chunk (auxBuffer itself is sized once in prepareToPlay)
+                juce::AudioBuffer<float> aux(auxBuffer.getArrayOfWritePointers() + job.step * numCh, numCh, numSamp);
+                aux.clear();
+
+                const auto anySent = sumHostedSends(schedule, schedule.steps[(size_t)job.step], bands, 0, bandLive,
+                    aux, sendRamp.getWritePointer(job.step));
+
+                processed[job.step] = runHostedInstance(job, aux, anySent);
+            });
+    }
+
+    // Return wet for any band/slot that routes to an instance
+    // (straight into the mix, the bands themselves are already summed)
+    syncRouteFades(schedule);
+
+    for (int j = 0; j < numJobs; ++j)
+        addHostedReturns(schedule, jobs[j],
+            processed[jobs[j].step] ? auxBuffer.getArrayOfReadPointers() + jobs[j].step * numCh : nullptr,
+            writtenBands, output, numSamp);
+
+    advanceRouteFades(schedule, numSamp);
+}
+
+int XPulseAudioProcessor::getHostedLatency(const RoutingGraph::Schedule& schedule)
+{
+    int latency = 0;
+
+    for (const auto& step : schedule.steps)
+        if (const auto* plugin = hostProcessor_.getPool().getInstanceForAudio(step.id))
+            latency = juce::jmax(latency, hostProcessor_.getPool().getLatencyForAudio(step.id, *plugin));
+
+    return juce::jmin(latency, delayCompensation.getMaxDelay());
+}
+
+int XPulseAudioProcessor::gatherHostedJobs(const RoutingGraph::Schedule& schedule, int level, juce::uint32 writtenBands,
+    HostedJob* jobs, double& estimatedSeconds)
+{
+    // Claiming a HostedActivity entry isn't thread safe, so it happens here before any of the instances run
+    int numJobs = 0;
+
+    for (int s = schedule.levelStarts[(size_t)level]; s < schedule.levelStarts[(size_t)level + 1]; ++s)
+    {
+        const auto& step = schedule.steps[(size_t)s];
+
+        // Instances fed only from bands that weren't written this block sit this one out
+        if ((step.bandMask & writtenBands) == 0)
+            continue;
+
+        auto* plugin = hostProcessor_.getPool().getInstanceForAudio(step.id);
+        if (!plugin)
+            continue;
+
+        auto& job = jobs[numJobs++];
+        job.step = s;
+        job.plugin = plugin;
+        job.latency = hostProcessor_.getPool().getLatencyForAudio(step.id, *plugin);
+        job.entry = &getHostedActivity(step.id, schedule.instanceIds.data(), (int)schedule.instanceIds.size());
+        estimatedSeconds += job.entry->averageSeconds;
+    }
+
+    return numJobs;
+}
+
+bool XPulseAudioProcessor::sumHostedSends(const RoutingGraph::Schedule& schedule, const RoutingGraph::Step& step,
+    const juce::AudioBuffer<float>& bands, int bandStart, const bool* bandLive, juce::AudioBuffer<float>& aux, float* ramp)
+{
+    const auto numCh = aux.getNumChannels();
+    const auto numSamp = aux.getNumSamples();
+    bool anySent = false;
+
+    // Sum sends from any live band/slot that routes to this instance
+    for (int i = step.firstSend; i < step.firstSend + step.numSends; ++i)
+    {
+        const auto& port = schedule.sends[(size_t)i];
+        const auto band = port.band;
+        const auto slot = port.slot;
+
+        if (!bandLive[band])
+            continue;
+
+        const float send = port.gain;
+
+        const auto destination = ModulationMatrix::sendDestination(band, slot);
+        const auto* sendModulation = modulationMatrix.getRamp(destination);
+
+        if (send + modulationMatrix.getMaximum(destination) <= 0.0001f)
+            continue;
+
+        if (sendModulation != nullptr)
+        {
+            // Modulated sends are applied per sample
+            juce::FloatVectorOperations::fill(ramp, send, numSamp);
+            addModulation(ramp, sendModulation + bandStart, numSamp);
+
+            for (int ch = 0; ch < numCh; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(aux.getWritePointer(ch), bands.getReadPointer(band * numCh + ch, bandStart), ramp, numSamp);
+        }
+        else
+        {
+            for (int ch = 0; ch < numCh; ++ch)
+                aux.addFrom(ch, 0, bands, band * numCh + ch, bandStart, numSamp, send);
+        }
+
+        anySent = true;
+    }
+
+    return anySent;
+}
+
+bool XPulseAudioProcessor::runHostedInstance(const HostedJob& job, juce::AudioBuffer<float>& aux, bool anySent)
+{
+    const auto numCh = aux.getNumChannels();
+    const auto numSamp = aux.getNumSamples();
+
+    // Sleeping plugins stay asleep until their input comes back
+    auto& activity = job.entry->activity;
+    const auto inputSilent = !anySent || Silence::isSilent(aux, 0, numCh, numSamp);
+
+    if (!activity.beginBlock(inputSilent, numSamp))
+        return false;
+
+    // Process hosted plugin once for this instance id (each job has its own MIDI buffer)
+    juce::MidiBuffer emptyMidi;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    job.plugin->processBlock(aux, emptyMidi);
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    job.entry->averageSeconds += (seconds - job.entry->averageSeconds) * kLoadSmoothing;
+
+    // Sleep only after the reported tail and once the output has measurably died away
+    // (an unknown or very long tail keeps the plugin awake)
+    const auto tailSeconds = job.plugin->getTailLengthSeconds();
+    const auto tailSamples = (std::isfinite(tailSeconds) && tailSeconds <= kMaxTrackedTailSeconds)
+        ? (int)std::ceil(tailSeconds * currentSampleRate)
+        : Silence::kMaxCount + 1;
+    const auto holdSamples = (int)(currentSampleRate * kPluginSleepHoldSeconds);
+
+    activity.endBlock(Silence::isSilent(aux, 0, numCh, numSamp), tailSamples, holdSamples, numSamp);
+
+    // Fade in whatever a freshly woken plugin resumes with
+    if (activity.isWaking())
+        for (int ch = 0; ch < numCh; ++ch)
+            aux.applyGainRamp(ch, 0, numSamp, 0.0f, 1.0f);
+
+    return true;
+}
+
+void XPulseAudioProcessor::addHostedReturns(const RoutingGraph::Schedule& schedule, const HostedJob& job,
+    const float* const* returned, juce::uint32 writtenBands, juce::AudioBuffer<float>& output, int numSamples)
+{
+    const auto& step = schedule.steps[(size_t)job.step];
+    const auto numCh = output.getNumChannels();
+
+    // Each route's return is held back by however much faster its instance is than the slowest one
+    const auto delay = juce::jmax(0, activeHostedLatency.load(std::memory_order_relaxed) - job.latency);
+
+    for (int i = step.firstReturn; i < step.firstReturn + step.numReturns; ++i)
+    {
+        const auto& port = schedule.returns[(size_t)i];
+        const auto band = port.band;
+        const auto slot = port.slot;
+
+        if (((writtenBands >> band) & 1u) == 0)
+            continue;
+
+        // The line keeps running at zero return too, so turning it up never replays old audio
+        const auto* const* delayed = delayCompensation.processReturn(getReturnLine(port, step.id), step.id,
+            returned, numCh, numSamples, delay);
+
+        const float ret = port.gain;
+
+        if (ret <= 0.0001f || returned == nullptr)
+            continue;
+
+        if (port.fade == RoutingGraph::noFade)
+        {
+            for (int ch = 0; ch < numCh; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(ch), delayed[ch], ret, numSamples);
+
+            continue;
+        }
+
+        // A swapped route crossfades, the new instance's return rising as the old one's falls
+        const auto& fade = routeFades[band * kNumSlots + slot];
+        const auto length = getSwapFadeSamples();
+        const auto fadingOut = port.fade == RoutingGraph::fadeOut;
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto* out = output.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto in = getSwapFadeGain(fade, i, length);
+                out[i] += delayed[ch][i] * ret * (fadingOut ? 1.0f - in : in);
+            }
+        }
+    }
+}
+
+void XPulseAudioProcessor::captureHostedSends(const juce::AudioBuffer<float>& bands,
+    juce::AudioBuffer<float>& output, juce::uint32 writtenBands, const bool* bandLive, int numCh, int numSamp)
+{
+    // A chunk can end one anticipative block and start the next, so it goes in pieces that fit
+    for (int done = 0; done < numSamp;)
+    {
+        const auto n = juce::jmin(numSamp - done, anticipativeRenderer.getSpace());
+        auto& block = anticipativeRenderer.getCaptureBlock();
+
+        // Routing changes are picked up at block starts only, so the render sees one schedule per block
+        if (anticipativeRenderer.getPosition() == 0)
+        {
+            block.schedule = activeSchedule;
+            block.numChannels = numCh;
+            block.writtenBands = 0;
+            block.sentSteps = 0;
+        }
+
+        block.writtenBands |= writtenBands;
+
+        if (block.schedule != nullptr)
+        {
+            for (int s = 0; s < (int)block.schedule->steps.size(); ++s)
+            {
+                juce::AudioBuffer<float> aux(block.sends.getArrayOfWritePointers() + s * numCh, numCh,
+                    anticipativeRenderer.getPosition(), n);
+                aux.clear();
+
+                if (sumHostedSends(*block.schedule, block.schedule->steps[(size_t)s], bands, done, bandLive, aux, sendRamp.getWritePointer(0)))
+                    block.sentSteps |= (juce::uint64)1 << s;
+            }
+        }
+
+        // Everything the returns are mixed with is held back by the block they are late
+        anticipativeRenderer.delayDry(output, done, n);
+        anticipativeRenderer.addWet(output, done, n);
+        anticipativeRenderer.advance(n);
+
+        done += n;
+    }
+}
+
+void XPulseAudioProcessor::renderAnticipativeBlock(AnticipativeRenderer::Block& block)
+{
+    block.wet.clear(0, block.numSamples);
+
+    if (block.schedule == nullptr)
+        return;
+
+    const auto& schedule = *block.schedule;
+    const auto numCh = block.numChannels;
+
+    // The returns go into the captured channel layout (any extra wet channels stay silent)
+    juce::AudioBuffer<float> wet(block.wet.getArrayOfWritePointers(), numCh, block.numSamples);
+
+    HostedJob jobs[kMaxHostedSteps];
+    bool processed[kMaxHostedSteps] = {};
+    int numJobs = 0;
+
+    for (int level = 0; level < schedule.getNumLevels(); ++level)
+    {
+        double estimatedSeconds = 0.0;
+        const auto firstJob = numJobs;
+        numJobs += gatherHostedJobs(schedule, level, block.writtenBands, jobs + firstJob, estimatedSeconds);
+
+        // The render thread is the only one running the instances (and using the pool) in this mode
+        runHostedJobs(numJobs - firstJob, estimatedSeconds, [&](int j)
+            {
+                const auto& job = jobs[firstJob + j];
+                juce::AudioBuffer<float> aux(block.sends.getArrayOfWritePointers() + job.step * numCh, numCh, block.numSamples);
+
+                processed[job.step] = runHostedInstance(job, aux, (block.sentSteps >> job.step) & 1u);
+            });
     }
+
+    syncRouteFades(schedule);
+
+    for (int j = 0; j < numJobs; ++j)
+        addHostedReturns(schedule, jobs[j],
+            processed[jobs[j].step] ? block.sends.getArrayOfReadPointers() + jobs[j].step * numCh : nullptr,
+            block.writtenBands, wet, block.numSamples);
+
+    advanceRouteFades(schedule, block.numSamples);
 }
 
 
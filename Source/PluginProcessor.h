@@ -10,11 +10,27 @@
 
 #include <JuceHeader.h>
 #include "HostProcessor.h"
+#include "BandSplitter.h"
+#include "LinearPhaseSplitter.h"
+#include "SmoothedGain.h"
+#include "BlockEngine.h"
+#include "SilenceTracking.h"
+#include "BandDynamics.h"
+#include "BandReverb.h"
+#include "SpectralMorph.h"
+#include "TextureBlend.h"
+#include "PerformanceFX.h"
+#include "ModulationMatrix.h"
+#include "AudioWorkerPool.h"
+#include "RoutingGraph.h"
+#include "AnticipativeRenderer.h"
+#include "DelayCompensation.h"
 
 //==============================================================================
 /**
 */
-class XPulseAudioProcessor  : public juce::AudioProcessor
+class XPulseAudioProcessor  : public juce::AudioProcessor,
+                              private juce::AsyncUpdater
 {
 public:
 	//Custom Prepare Functions
@@ -26,10 +42,17 @@ public:
 	const HostProcessor& getHostProcessor() const { return hostProcessor_; }
 
     // PitchDependent Functions for Audio
-    void pitchDependent(juce::AudioBuffer<float>& buffer);
-	void processLowBand(juce::AudioBuffer<float>& buffer);
-	void processMidBand(juce::AudioBuffer<float>& buffer);
-	void processHighBand(juce::AudioBuffer<float>& buffer);
+    void pitchDependent(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain);
+	void prepareBandMix(BandSplitter::BandMix& mix, int numBands, int numSamples);
+	void mixBands(juce::AudioBuffer<float>& output, const BandSplitter::BandMix& mix, int numBands, int numSamples);
+	void prepareReverbs(float* wet, BandSplitter::BandMix& mix, int numBands);
+	void processReverbs(juce::AudioBuffer<float>& output, const float* wet, int numBands, int numCh, int numSamples);
+	static void getReverbBands(int slot, int numBands, int& firstBand, int& lastBand);
+	bool prepareDynamics(BandDynamics::BandSettings* settings, bool* dynamicsBands, BandSplitter::BandMix& mix, int numBands);
+	bool prepareMorph(SpectralMorph::BandSettings* settings, BandSplitter::BandMix& mix, int numBands);
+	bool prepareTextures(TextureBlend::BandSettings* settings, bool* textureBands, BandSplitter::BandMix& mix, int numBands);
+	bool preparePerformance(PerformanceFX::Settings& settings, bool* armedBands, BandSplitter::BandMix& mix, int numBands, int numSamples);
+	int prepareModulationRoutes(ModulationMatrix::Route* routes);
 
 	void pitchDependent(juce::MidiBuffer& midiMessages);
 	void processLowBand(juce::MidiBuffer& midiMessages);
@@ -87,23 +110,65 @@ public:
 	// Create an instance of the Audio Processor Value Tree State(APVTS)
     juce::AudioProcessorValueTreeState parameters;
 
-	// Hosted Plugin Send Functions
-    void setBandPluginInstanceId(int band, int slot, uint32_t id)
+	// Band layout limits (the active count comes from the "numBands" parameter)
+	static constexpr int kMinBands = BandSplitter::kMinBands;
+	static constexpr int kMaxBands = BandSplitter::kMaxBands;
+	static constexpr int kNumSlots = 3;
+
+	// Longest serial insert chain a band can have
+	static constexpr int kMaxInserts = 8;
+
+	// Parameter IDs per band / crossover (the first ones keep their original 3-band names)
+	static juce::String getBandGainParamId(int band);
+	static juce::String getCrossoverParamId(int crossover);
+	static juce::String getDynamicsParamId(int band, const char* name);
+	static juce::String getReverbParamId(int slot, const char* name);
+	static juce::String getMorphParamId(int band, const char* name);
+	static juce::String getTextureParamId(int band, const char* name);
+	static juce::String getPerformanceParamId(int band, const char* name);
+	static juce::String getModulationParamId(int route, const char* name);
+
+	// Hosted Plugin Send Functions (message thread, each change recompiles the routing schedule).
+	// A new instance crossfades in over the old one, which is destroyed once faded out if releasePrevious is set
+    void setBandPluginInstanceId(int band, int slot, uint32_t id, bool releasePrevious = false);
+
+    uint32_t getBandPluginInstanceId(int band, int slot) const
     {
-        if ((unsigned)band < kNumBands && (unsigned)slot < kNumSlots)
-            bandPluginInstanceId[band][slot].store(id, std::memory_order_relaxed);
+        return (unsigned)band < kMaxBands && (unsigned)slot < kNumSlots
+            ? bandPluginInstanceId[band][slot].load(std::memory_order_relaxed) : 0;
     }
 
     void setBandSendAmount(int band, int slot, float v)
     {
-        if ((unsigned)band < kNumBands && (unsigned)slot < kNumSlots)
+        if ((unsigned)band < kMaxBands && (unsigned)slot < kNumSlots)
+        {
             bandSendAmount[band][slot].store(juce::jlimit(0.0f, 1.0f, v), std::memory_order_relaxed);
+            rebuildRoutingSchedule();
+        }
     }
 
     void setBandReturnAmount(int band, int slot, float v)
     {
-        if ((unsigned)band < kNumBands && (unsigned)slot < kNumSlots)
+        if ((unsigned)band < kMaxBands && (unsigned)slot < kNumSlots)
+        {
             bandReturnAmount[band][slot].store(juce::jlimit(0.0f, 1.0f, v), std::memory_order_relaxed);
+            rebuildRoutingSchedule();
+        }
+    }
+
+	// Insert Chain Functions (message thread, each change recompiles the routing schedule)
+    void setBandInsertInstanceId(int band, int position, uint32_t id, bool releasePrevious = false);
+    void setBandInsertLength(int band, int length);
+
+    uint32_t getBandInsertInstanceId(int band, int position) const
+    {
+        return (unsigned)band < kMaxBands && (unsigned)position < kMaxInserts
+            ? bandInsertInstanceId[band][position].load(std::memory_order_relaxed) : 0;
+    }
+
+    int getBandInsertLength(int band) const
+    {
+        return (unsigned)band < kMaxBands ? bandInsertLength[band].load(std::memory_order_relaxed) : 0;
     }
     
 	// Band Splitter Functions
@@ -113,26 +178,328 @@ private:
 	// Default sample rate (will be updated in prepareToPlay)
     double currentSampleRate = 44100.0;
 
-	// Function to update band filter coefficients based on current parameter values
-    void updateBandFilterCutoffs();
+	// Publishes the active crossovers (sorted) to the band splitters as ramp targets (lock-free, no allocation)
+    void pushCrossoverTargets(int numBands);
 
-	// Constants for band processing
-	static constexpr int kNumBands = 3; // Low, Mid, High
-	static constexpr int kNumSlots = 3;
+	// Active band count from the "numBands" parameter (audio thread)
+    int getNumBands() const;
 
-    // Hosted plugin send routing
-    std::atomic<uint32_t> bandPluginInstanceId[kNumBands][kNumSlots];
-    std::atomic<float>    bandSendAmount[kNumBands][kNumSlots]; 
-    std::atomic<float>    bandReturnAmount[kNumBands][kNumSlots];
+	// Every APVTS parameter the audio thread reads, resolved to its raw value once in the constructor
+	// so processBlock never does a string-keyed lookup
+    struct ParameterBindings
+    {
+        std::atomic<float>* bandGain[kMaxBands] = {};
+        std::atomic<float>* crossover[kMaxBands - 1] = {};
+        std::atomic<float>* numBands = nullptr;
+        std::atomic<float>* crossoverMode = nullptr;
+        std::atomic<float>* blockMode = nullptr;
+        std::atomic<float>* hostingMode = nullptr;
+        std::atomic<float>* swapFade = nullptr;
+
+        std::atomic<float>* dynamicsMode[kMaxBands] = {};
+        std::atomic<float>* dynamicsThreshold[kMaxBands] = {};
+        std::atomic<float>* dynamicsRatio[kMaxBands] = {};
+        std::atomic<float>* dynamicsAttack[kMaxBands] = {};
+        std::atomic<float>* dynamicsRelease[kMaxBands] = {};
+        std::atomic<float>* dynamicsMakeup[kMaxBands] = {};
+        std::atomic<float>* reverbMaster[BandReverb::kNumSlots] = {};
+        std::atomic<float>* reverbPreset[BandReverb::kNumSlots] = {};
+        std::atomic<float>* dynamicsLink = nullptr;
+        std::atomic<float>* dynamicsLookahead = nullptr;
+
+        std::atomic<float>* morphTarget[kMaxBands] = {};
+        std::atomic<float>* morphAmount[kMaxBands] = {};
+        std::atomic<float>* morphFftSize = nullptr;
+        std::atomic<float>* morphHop = nullptr;
+
+        std::atomic<float>* textureMix[kMaxBands] = {};
+        std::atomic<float>* textureSize[kMaxBands] = {};
+        std::atomic<float>* textureDensity[kMaxBands] = {};
+        std::atomic<float>* texturePitch[kMaxBands] = {};
+        std::atomic<float>* textureSpray[kMaxBands] = {};
+        std::atomic<float>* textureSpread[kMaxBands] = {};
+
+        std::atomic<float>* performanceArm[kMaxBands] = {};
+        std::atomic<float>* performanceMidiChannel = nullptr;
+        std::atomic<float>* performanceReverseLength = nullptr;
+        std::atomic<float>* performanceTapeStop = nullptr;
+
+        std::atomic<float>* modulationSource[ModulationMatrix::kMaxRoutes] = {};
+        std::atomic<float>* modulationDestination[ModulationMatrix::kMaxRoutes] = {};
+        std::atomic<float>* modulationDepth[ModulationMatrix::kMaxRoutes] = {};
+    };
+
+    ParameterBindings boundParameters;
+    void bindParameters();
+
+	// Crossover modes (index of the "crossoverMode" choice parameter)
+    enum CrossoverMode { minimumPhaseMode = 0, linearPhaseMode };
+
+	// Mode the audio thread is currently splitting with (read on the message thread for latency reporting)
+    std::atomic<int> activeCrossoverMode{ minimumPhaseMode };
+
+    int getCrossoverLatency(int mode) const;
+
+	// Block engine mode the audio thread is currently running (BlockEngine::Mode)
+    std::atomic<int> activeBlockMode{ BlockEngine::hostBlocks };
+
+	// Hosting modes (index of the "hostingMode" choice parameter)
+    enum HostingMode { realtimeHosting = 0, anticipativeHosting };
+
+	// Whether the hosted plugins currently run one block ahead (adds one chunk of latency)
+    std::atomic<bool> activeAnticipative{ false };
+
+	// Whether the dynamics lookahead is currently delaying the band path
+    std::atomic<bool> activeLookahead{ false };
+
+	// Latency of the spectral morph stage (0 while no band morphs)
+    std::atomic<int> activeMorphLatency{ 0 };
+
+	// Whether any active band has a morph target selected
+    bool isMorphing(int numBands) const;
+
+	// MIDI channel the performance FX trigger notes arrive on (1-16)
+    int getPerformanceMidiChannel() const;
+
+	// Host tempo/position for the performance FX, read at the start of each host block
+    PerformanceFX::Transport getTransport();
+
+	// Crossover latency + block engine latency + dynamics lookahead + morph stage for the active modes
+    int getReportedLatency() const;
+
+	// Reports the latency of the active modes to the host (message thread)
+    void handleAsyncUpdate() override;
+
+    // Hosted plugin send routing (band-major, sized for the maximum band count). Only the message thread
+    // reads these, the audio thread gets them compiled into the routing schedule
+    std::atomic<uint32_t> bandPluginInstanceId[kMaxBands][kNumSlots];
+    std::atomic<float>    bandSendAmount[kMaxBands][kNumSlots]; 
+    std::atomic<float>    bandReturnAmount[kMaxBands][kNumSlots];
+
+    // Serial insert chains, processed in place on the band (only the first bandInsertLength[band] positions run)
+    std::atomic<uint32_t> bandInsertInstanceId[kMaxBands][kMaxInserts];
+    std::atomic<int>      bandInsertLength[kMaxBands];
 
     
     // buffers reused per block (no allocations in processBlock)
-    juce::AudioBuffer<float> lowBuffer, midBuffer, highBuffer;
+    // bandBuffers holds every band back to back in one allocation: band b, channel c = channel b * numCh + c
+    // Only bands that feed hosted plugins are written there (see BandSplitter::BandMix)
+    juce::AudioBuffer<float> bandBuffers;
+    // auxBuffer has numCh channels per hosted instance processed in a block, so the instances can run side by side
     juce::AudioBuffer<float> auxBuffer;
 
-    void processHostedSends(juce::AudioBuffer<float>& low,
-        juce::AudioBuffer<float>& mid,
-        juce::AudioBuffer<float>& high);
+	// Sum of the bands feeding one reverb slot
+    juce::AudioBuffer<float> reverbInput;
+
+	// Per-sample band gain ramps (one channel per band, only filled while a gain is moving)
+    juce::AudioBuffer<float> gainRamps;
+
+	// Scratch ramps for modulated send amounts (one channel per hosted instance, like auxBuffer)
+    juce::AudioBuffer<float> sendRamp;
+
+	// Adds a modulation offset ramp to per-sample parameter values, clamped to the 0..1 range
+    static void addModulation(float* values, const float* offsets, int numSamples);
+
+	// Sleep/tail tracking for the hosted instances in use (audio thread, one entry per possible step)
+    struct HostedActivity
+    {
+        PluginPool::InstanceId id = 0;
+        PluginActivity activity;
+
+        // Running average of the instance's processBlock time, for deciding whether a block is worth spreading over the workers
+        double averageSeconds = 0.0;
+    };
+
+	// Steps a schedule can have: one instance per route, plus the old one of every route being swapped
+    static constexpr int kMaxHostedSteps = 2 * kMaxBands * kNumSlots;
+
+    HostedActivity hostedActivity[kMaxHostedSteps];
+
+	// Finds (or claims) the tracker for a hosted instance among the ones routed this block
+    HostedActivity& getHostedActivity(PluginPool::InstanceId id, const PluginPool::InstanceId* usedIds, int numUsed);
+
+	// Hosted routing compiled into a schedule (see RoutingGraph). The message thread publishes routingSchedule,
+	// the audio thread takes it into activeSchedule at the start of each host block (a plain load, no refcount)
+    std::atomic<const RoutingGraph::Schedule*> routingSchedule{ nullptr };
+    const RoutingGraph::Schedule* activeSchedule = nullptr;
+
+	// The published schedule, and the ones it replaced with the quiescent epoch they were replaced at.
+	// Owned by the message thread, which frees a replaced one once the audio side can't hold it any more
+    struct RetiredSchedule
+    {
+        std::unique_ptr<const RoutingGraph::Schedule> schedule;
+        juce::uint32 epoch = 0;
+    };
+
+    std::unique_ptr<const RoutingGraph::Schedule> publishedSchedule;
+    std::vector<RetiredSchedule> retiredSchedules;
+
+	// Recompiles the schedule from bandPluginInstanceId (message thread)
+    void rebuildRoutingSchedule();
+
+	// Frees the replaced schedules two quiescent points old (message thread)
+    void freeRetiredSchedules();
+
+	// Runs the hosted instances of a block in parallel (the audio thread takes part as well)
+    AudioWorkerPool workerPool;
+
+	// One instance to run: the schedule step, with the pool and activity lookups already resolved
+    struct HostedJob
+    {
+        int step = 0;
+        juce::AudioPluginInstance* plugin = nullptr;
+        HostedActivity* entry = nullptr;
+
+        // Latency of the instance's output (probed or reported, see PluginPool)
+        int latency = 0;
+    };
+
+	// Resolves the steps of one schedule level fed from writtenBands, adding up their expected cost.
+	// Not thread safe: only one thread runs the hosted instances at a time
+    int gatherHostedJobs(const RoutingGraph::Schedule& schedule, int level, juce::uint32 writtenBands,
+        HostedJob* jobs, double& estimatedSeconds);
+
+	// Runs job(index) for every job, spread over the workers unless the level is too light to be worth it
+    template <typename Job>
+    void runHostedJobs(int numJobs, double estimatedSeconds, Job&& job)
+    {
+        if (numJobs < 2 || estimatedSeconds < kMinParallelSeconds)
+        {
+            for (int j = 0; j < numJobs; ++j)
+                job(j);
+        }
+        else
+        {
+            workerPool.run(numJobs, job);
+        }
+    }
+
+	// Sums the live sends of one step into aux (bands and modulation ramps are read from bandStart on).
+	// Returns false when nothing was sent
+    bool sumHostedSends(const RoutingGraph::Schedule& schedule, const RoutingGraph::Step& step,
+        const juce::AudioBuffer<float>& bands, int bandStart, const bool* bandLive, juce::AudioBuffer<float>& aux, float* ramp);
+
+	// Runs one instance over aux in place, with sleep tracking and the wake fade. Returns false while it sleeps
+    bool runHostedInstance(const HostedJob& job, juce::AudioBuffer<float>& aux, bool anySent);
+
+	// Adds a job's delay compensated returns for the routes from writtenBands (returned is null while
+	// the instance sleeps, which still moves its delay lines on)
+    void addHostedReturns(const RoutingGraph::Schedule& schedule, const HostedJob& job,
+        const float* const* returned, juce::uint32 writtenBands, juce::AudioBuffer<float>& output, int numSamples);
+
+	// Hot swaps: a route or insert position that changes instance runs the old and the new one side by side
+	// for "swapFade" ms, crossfading between them, and only then drops the old one (see RoutingGraph).
+	// The message thread keeps track of the swaps in flight, the audio side of how far each fade got
+    struct InstanceSwap
+    {
+        PluginPool::InstanceId previous = 0;
+        bool fading = false;
+
+        // Destroy previous once it has faded out
+        bool releasePrevious = false;
+    };
+
+    InstanceSwap routeSwaps[kMaxBands][kNumSlots];
+    InstanceSwap insertSwaps[kMaxBands][kMaxInserts];
+
+    struct SwapFade
+    {
+        PluginPool::InstanceId from = 0;
+        PluginPool::InstanceId to = 0;
+        int position = 0;
+        bool finished = false;
+    };
+
+	// Route fades by band * kNumSlots + slot, insert fades by band and index in the chain
+    SwapFade routeFades[kMaxBands * kNumSlots];
+    SwapFade insertFades[kMaxBands][kMaxInserts];
+
+	// Fades that have run their course (packSwap(from, to), 0 for none), finished off in handleAsyncUpdate
+    std::atomic<juce::uint64> finishedRouteFades[kMaxBands * kNumSlots];
+    std::atomic<juce::uint64> finishedInsertFades[kMaxBands][kMaxInserts];
+
+    static juce::uint64 packSwap(PluginPool::InstanceId from, PluginPool::InstanceId to) noexcept { return ((juce::uint64)from << 32) | to; }
+
+	// Fade length from the "swapFade" parameter
+    int getSwapFadeSamples() const;
+
+	// Moves a fade onto the swap from -> to, from the start unless it was already on it
+    static void syncSwapFade(SwapFade& fade, PluginPool::InstanceId from, PluginPool::InstanceId to);
+
+	// Moves a fade on by numSamples. True the one time it reaches the end
+    static bool advanceSwapFade(SwapFade& fade, int numSamples, int length);
+
+	// Gain of the instance faded in, sample index samples into the fade
+    static float getSwapFadeGain(const SwapFade& fade, int index, int length) noexcept
+    {
+        return juce::jmin(1.0f, (float)(fade.position + index + 1) / (float)length);
+    }
+
+	// Route fades: synced to the schedule before its returns are added, moved on after (whichever thread adds them)
+    void syncRouteFades(const RoutingGraph::Schedule& schedule);
+    void advanceRouteFades(const RoutingGraph::Schedule& schedule, int numSamples);
+
+	// Which of a route's two return lines an instance goes through, so one swapped out keeps its own
+    int getReturnLine(const RoutingGraph::Port& port, PluginPool::InstanceId id) const;
+
+	// Ends a swap, returning the instance to destroy once the schedule no longer has it (0 for none)
+    PluginPool::InstanceId endSwap(InstanceSwap& swap);
+
+	// Destroys an instance swapped out, unless it is routed somewhere again
+    void releaseSwappedOut(PluginPool::InstanceId id);
+
+	// Delay lines lining the returns and the mix up with the slowest routed instance
+    DelayCompensation delayCompensation;
+
+	// Latency the hosted path is compensated to (added to the reported latency)
+    std::atomic<int> activeHostedLatency{ 0 };
+
+	// Slowest routed instance, clamped to what the delay lines hold (audio thread)
+    int getHostedLatency(const RoutingGraph::Schedule& schedule);
+
+	// Sleep/tail tracking for the insert positions (a slot's own entry, so the chains never share one)
+    HostedActivity insertActivity[kMaxBands][kMaxInserts];
+
+	// The old instance of a swapped insert runs on a copy of its band (numCh channels per band), tracked apart
+    juce::AudioBuffer<float> insertFadeBuffer;
+    HostedActivity insertFadeActivity[kMaxBands][kMaxInserts];
+
+	// Delay lines lining the bands and the mix up with the slowest insert chain
+    DelayCompensation insertCompensation;
+
+	// Latency the insert chains are compensated to (added to the reported latency)
+    std::atomic<int> activeInsertLatency{ 0 };
+
+	// Runs the insert chains in place on their (held-out) bands, then delays the mix and the other
+	// written bands to line up with the slowest chain
+    void processInserts(juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+        const BandSplitter::BandMix& mix, int numBands, int numCh, int numSamp);
+
+	// Anticipative hosting: the audio thread captures the sends, the instances run a block later on the render thread
+    AnticipativeRenderer anticipativeRenderer{ [this](AnticipativeRenderer::Block& block) { renderAnticipativeBlock(block); } };
+
+	// Captures one chunk of sends for the anticipative renderer and mixes in the wet rendered a block earlier
+    void captureHostedSends(const juce::AudioBuffer<float>& bands,
+        juce::AudioBuffer<float>& output, juce::uint32 writtenBands, const bool* bandLive, int numCh, int numSamp);
+
+	// Runs the instances over a captured block (render thread)
+    void renderAnticipativeBlock(AnticipativeRenderer::Block& block);
+
+	// Below this much estimated plugin time per block, waking the workers costs more than it saves
+    static constexpr double kMinParallelSeconds = 0.00005;
+
+	// Weight of the newest measurement in HostedActivity::averageSeconds
+    static constexpr double kLoadSmoothing = 0.1;
+
+	// A plugin's output has to stay below Silence::kThreshold this long (after its tail) before it sleeps
+    static constexpr double kPluginSleepHoldSeconds = 0.5;
+
+	// Reported tails longer than this (or infinite) are treated as "never sleep"
+    static constexpr double kMaxTrackedTailSeconds = 60.0;
+
+	// Sends the flagged bands to their hosted plugins and adds the returns straight into output
+    void processHostedSends(const juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+        const BandSplitter::BandMix& mix, int numBands, int numChannels, int numSamples);
 
 
 	// This is a custom function to create the parameter layout for the APVTS
@@ -142,23 +509,36 @@ private:
     HostProcessor hostProcessor_; 
 
 	// ======== DSP processors ========
-	//Gain processor
-	juce::dsp::Gain<float> highGainProcessor;
-    juce::dsp::Gain<float> midGainProcessor;
-	juce::dsp::Gain<float> lowGainProcessor;
-
-	//Band filters
-    juce::dsp::IIR::Coefficients<float>::Ptr lowBandCoefficients;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> lowBand;
-
-	juce::dsp::IIR::Coefficients<float>::Ptr midBandCoefficients;
-    juce::dsp::ProcessorChain<
-        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
-        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>
-    > midBand;
-
-	juce::dsp::IIR::Coefficients<float>::Ptr highBandCoefficients;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highBand;
+	//Band gains (smoothed, applied inside the fused split/mix kernel)
+	SmoothedGain bandGains[kMaxBands];
+	static constexpr double kGainRampSeconds = 0.02;
+
+	//Band filters (LR4 split chain, writes straight into bandBuffers)
+    BandSplitter bandSplitter;
+
+	//Linear-phase alternative for mastering (adds latency, see getCrossoverLatency)
+    LinearPhaseSplitter linearPhaseSplitter;
+
+	//Per-band compressor/expander (runs on the bands the split holds out of its mix)
+    BandDynamics bandDynamics;
+
+	//Native reverbs for the low / mid / high reverb slots (pitch-dependent FX)
+    BandReverb bandReverb;
+
+	//Spectral morph between bands or towards the sidechain (runs after the dynamics)
+    SpectralMorph spectralMorph;
+
+	//Granular texture per band, blended in on top of the mix
+    TextureBlend textureBlend;
+
+	//Tempo-synced repeat / reverse / tape stop on the armed bands, triggered by MIDI notes
+    PerformanceFX performanceFX;
+
+	//Velocity / note count / aftertouch routed to band gains, sends and FX wet levels
+    ModulationMatrix modulationMatrix;
+
+	//Slices/accumulates host blocks into the chunks the DSP chain runs on
+    BlockEngine blockEngine;
     //Custom Variables
 	
 
@@ -0,0 +1,210 @@
+#include "RoutingGraph.h"
+
+RoutingGraph::RoutingGraph(const Route* routes, int numBands, int numSlots,
+    const InstanceId* inserts, const int* insertLengths, int maxInserts, const InstanceId* insertPrevious)
+{
+    jassert(numBands <= 32);
+
+    for (int band = 0; band < numBands; ++band)
+        nodes.push_back({ bandNode, band, 0 });
+
+    const auto mix = (int)nodes.size();
+    nodes.push_back({ mixNode, -1, 0 });
+
+    // Chains first, they own their instances (empty positions are skipped over)
+    std::vector<InstanceId> chained;
+
+    auto isChained = [&chained](InstanceId id) { return std::find(chained.begin(), chained.end(), id) != chained.end(); };
+
+    for (int band = 0; inserts != nullptr && band < numBands; ++band)
+    {
+        auto previous = band;
+        const auto length = juce::jlimit(0, maxInserts, insertLengths[band]);
+
+        for (int position = 0; position < length; ++position)
+        {
+            auto id = inserts[band * maxInserts + position];
+            auto fadingFrom = insertPrevious != nullptr ? insertPrevious[band * maxInserts + position] : 0;
+
+            // The same instance twice would run twice per block
+            if (id != 0 && isChained(id))
+            {
+                jassertfalse;
+                id = 0;
+            }
+
+            // The old instance of a swapped position runs alongside the new one until faded out
+            if (fadingFrom == id || (fadingFrom != 0 && isChained(fadingFrom)))
+                fadingFrom = 0;
+
+            if (id == 0 && fadingFrom == 0)
+                continue;
+
+            if (id != 0) chained.push_back(id);
+            if (fadingFrom != 0) chained.push_back(fadingFrom);
+
+            nodes.push_back({ insertNode, band, id, fadingFrom });
+
+            const auto node = (int)nodes.size() - 1;
+            edges.push_back({ previous, node, band, position, insertEdge, 1.0f });
+            previous = node;
+        }
+
+        if (previous != band)
+            edges.push_back({ previous, mix, band, length, insertEdge, 1.0f });
+    }
+
+    // One node per hosted instance, however many routes feed it
+    auto findInstance = [this](InstanceId id)
+        {
+            for (int n = 0; n < (int)nodes.size(); ++n)
+                if (nodes[(size_t)n].type == instanceNode && nodes[(size_t)n].id == id)
+                    return n;
+
+            nodes.push_back({ instanceNode, -1, id });
+            return (int)nodes.size() - 1;
+        };
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            const auto& route = routes[band * numSlots + slot];
+            const auto current = route.id != 0 && !isChained(route.id);
+
+            // A route at zero send stays in, its instance keeps running so the tail rings out
+            if (current)
+            {
+                const auto instance = findInstance(route.id);
+                edges.push_back({ band, instance, band, slot, sendEdge, route.send });
+                edges.push_back({ instance, mix, band, slot, returnEdge, route.ret, route.fading ? fadeIn : noFade });
+            }
+
+            if (!route.fading)
+                continue;
+
+            // The instance swapped out keeps its send until its return has faded to nothing
+            const auto from = route.previous != route.id && route.previous != 0 && !isChained(route.previous) ? route.previous : 0;
+            if (from != 0)
+            {
+                const auto instance = findInstance(from);
+                edges.push_back({ band, instance, band, slot, sendEdge, route.send });
+                edges.push_back({ instance, mix, band, slot, returnEdge, route.ret, fadeOut });
+            }
+
+            fades.push_back({ band, slot, route.previous, route.id });
+        }
+    }
+}
+
+std::unique_ptr<const RoutingGraph::Schedule> RoutingGraph::compile() const
+{
+    const auto numNodes = (int)nodes.size();
+
+    // Kahn's algorithm, tracking the longest path to each node as its level
+    std::vector<int> inDegree((size_t)numNodes, 0);
+    std::vector<int> level((size_t)numNodes, 0);
+
+    for (const auto& edge : edges)
+        ++inDegree[(size_t)edge.to];
+
+    std::vector<int> order;
+    order.reserve((size_t)numNodes);
+
+    for (int n = 0; n < numNodes; ++n)
+        if (inDegree[(size_t)n] == 0)
+            order.push_back(n);
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const auto n = order[i];
+
+        for (const auto& edge : edges)
+        {
+            if (edge.from != n)
+                continue;
+
+            level[(size_t)edge.to] = juce::jmax(level[(size_t)edge.to], level[(size_t)n] + 1);
+
+            if (--inDegree[(size_t)edge.to] == 0)
+                order.push_back(edge.to);
+        }
+    }
+
+    // Routes only ever go band -> instance -> mix, so there is nothing to break a cycle with
+    jassert((int)order.size() == numNodes);
+
+    // The band splits and the mix are run by the processor itself, the schedule holds the instances
+    std::vector<int> instances;
+    for (auto n : order)
+        if (nodes[(size_t)n].type == instanceNode)
+            instances.push_back(n);
+
+    // Level by level, in the order the routes first reached each instance
+    std::sort(instances.begin(), instances.end(),
+        [&](int a, int b) { return level[(size_t)a] != level[(size_t)b] ? level[(size_t)a] < level[(size_t)b] : a < b; });
+
+    auto schedule = std::make_unique<Schedule>();
+    schedule->steps.reserve(instances.size());
+    schedule->instanceIds.reserve(instances.size());
+
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        const auto n = instances[i];
+
+        Step step;
+        step.id = nodes[(size_t)n].id;
+        step.firstSend = (int)schedule->sends.size();
+        step.firstReturn = (int)schedule->returns.size();
+
+        for (const auto& edge : edges)
+        {
+            if (edge.to == n)
+            {
+                schedule->sends.push_back({ edge.band, edge.slot, edge.gain });
+                step.bandMask |= 1u << edge.band;
+            }
+            else if (edge.from == n)
+            {
+                schedule->returns.push_back({ edge.band, edge.slot, edge.gain, edge.fade });
+            }
+        }
+
+        step.numSends = (int)schedule->sends.size() - step.firstSend;
+        step.numReturns = (int)schedule->returns.size() - step.firstReturn;
+        schedule->routedBands |= step.bandMask;
+
+        if (i > 0 && level[(size_t)n] != level[(size_t)instances[i - 1]])
+            schedule->levelStarts.push_back((int)i);
+
+        schedule->steps.push_back(step);
+        schedule->instanceIds.push_back(step.id);
+    }
+
+    if (!instances.empty())
+        schedule->levelStarts.push_back((int)instances.size());
+
+    // The inserts were added band by band in chain order, which is already their processing order
+    for (int n = 0; n < numNodes; ++n)
+    {
+        const auto& node = nodes[(size_t)n];
+        if (node.type != insertNode)
+            continue;
+
+        if (schedule->chains.empty() || schedule->chains.back().band != node.band)
+            schedule->chains.push_back({ node.band, (int)schedule->inserts.size(), 0 });
+
+        schedule->inserts.push_back(node.id);
+        schedule->insertPrevious.push_back(node.previous);
+        ++schedule->chains.back().length;
+        schedule->insertBands |= 1u << node.band;
+
+        for (auto id : { node.id, node.previous })
+            if (id != 0)
+                schedule->instanceIds.push_back(id);
+    }
+
+    schedule->fades = fades;
+
+    return schedule;
+}
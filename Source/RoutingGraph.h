@@ -0,0 +1,173 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PluginPool.h"
+
+// Processing graph for the hosted plugin routing, compiled into a flat schedule for the audio thread.
+//
+// Nodes are the band splits, the hosted instances and the output mix; the edges are the sends
+// (band -> instance, one per band/slot route), the returns (instance -> mix) and the insert chains
+// (band -> first insert -> ... -> last insert -> mix, in place on the band). The graph is built
+// and topologically sorted on the message thread whenever the routing changes, which gives a
+// Schedule: the instance steps in dependency order, grouped into levels whose steps don't depend on
+// each other (so each level can go to the worker pool as one batch), with every step's sends and
+// returns stored back to back, each with its amount. The audio thread only walks those arrays, so
+// it never scans the routing table and never sees an id and an amount from different edits.
+//
+// Insert chains run on their band before anything else reads it, so they are a stage of their own:
+// one chain per band, serial inside, independent of the other bands' chains. An instance is only
+// ever run once per block, so one that already sits in a chain is dropped from any other route.
+//
+// A route or insert position that just changed instance keeps its old one in the graph until the
+// processor has crossfaded from it to the new one: its ports are marked as fading out or in, and the
+// swap is listed in the schedule's fades.
+//
+// Schedules are immutable once published. The processor swaps in a new one at the start of a host
+// block, so a routing change never lands halfway through one, and frees the old one once the audio
+// side has passed two quiescent points since (see PluginPool::markQuiescent).
+class RoutingGraph
+{
+public:
+    using InstanceId = PluginPool::InstanceId;
+
+    // One entry of the band x slot routing table
+    struct Route
+    {
+        InstanceId id = 0;      // 0 = unrouted
+        float send = 0.0f;
+        float ret = 1.0f;
+
+        // Set while the route crossfades from previous (0 if it had none) to id
+        InstanceId previous = 0;
+        bool fading = false;
+    };
+
+    // How a port's return takes part in a route's crossfade
+    enum PortFade
+    {
+        noFade,
+        fadeIn,
+        fadeOut
+    };
+
+    // A route crossfading from one instance to another. Either can be 0: nothing to fade from, or to
+    struct Fade
+    {
+        int band = 0;
+        int slot = 0;
+        InstanceId from = 0;
+        InstanceId to = 0;
+    };
+
+    enum NodeType
+    {
+        bandNode,
+        instanceNode,
+        insertNode,
+        mixNode
+    };
+
+    struct Node
+    {
+        NodeType type = bandNode;
+        int band = -1;          // band and insert nodes
+        InstanceId id = 0;      // instance and insert nodes
+        InstanceId previous = 0; // insert nodes crossfading from another instance
+    };
+
+    enum EdgeType
+    {
+        sendEdge,               // band -> instance, for one band/slot route
+        returnEdge,             // instance -> mix, for one band/slot route
+        insertEdge              // along a band's insert chain (slot is the position it leads to)
+    };
+
+    struct Edge
+    {
+        int from = 0;
+        int to = 0;
+        int band = 0;
+        int slot = 0;
+        EdgeType type = sendEdge;
+        float gain = 1.0f;      // send or return amount
+        PortFade fade = noFade;
+    };
+
+    // One band/slot route, as seen by a step
+    struct Port
+    {
+        int band = 0;
+        int slot = 0;
+        float gain = 1.0f;
+        PortFade fade = noFade;
+    };
+
+    // One hosted instance to run: its sends and returns are [first, first + num) in the schedule's arrays
+    struct Step
+    {
+        InstanceId id = 0;
+        int firstSend = 0, numSends = 0;
+        int firstReturn = 0, numReturns = 0;
+
+        // Bands feeding this instance, as bits
+        juce::uint32 bandMask = 0;
+    };
+
+    // One band's insert chain: inserts [first, first + length) of the schedule, in processing order
+    struct Chain
+    {
+        int band = 0;
+        int first = 0;
+        int length = 0;
+    };
+
+    struct Schedule
+    {
+        std::vector<Step> steps;
+        std::vector<Port> sends;
+        std::vector<Port> returns;
+
+        // Steps [levelStarts[l], levelStarts[l + 1]) are independent of each other
+        std::vector<int> levelStarts{ 0 };
+
+        std::vector<Chain> chains;
+        std::vector<InstanceId> inserts;
+
+        // Per insert, the instance it crossfades from (0 when it isn't fading). An insert with its id 0
+        // is one fading out of the chain
+        std::vector<InstanceId> insertPrevious;
+
+        // Routes crossfading between instances
+        std::vector<Fade> fades;
+
+        // Instance ids of all the steps (in step order), then of all the inserts and those they fade from
+        std::vector<InstanceId> instanceIds;
+
+        // Bands with at least one route, and bands with an insert chain, as bits
+        juce::uint32 routedBands = 0;
+        juce::uint32 insertBands = 0;
+
+        int getNumLevels() const noexcept { return (int)levelStarts.size() - 1; }
+        bool isBandRouted(int band) const noexcept { return (routedBands >> band) & 1u; }
+        bool hasInserts(int band) const noexcept { return (insertBands >> band) & 1u; }
+    };
+
+    // Builds the graph for a band x slot routing table (routes[band * numSlots + slot]) and the bands'
+    // insert chains (inserts[band * maxInserts + position], the first insertLengths[band] used, with
+    // insertPrevious the instance each position crossfades from, or 0)
+    RoutingGraph(const Route* routes, int numBands, int numSlots,
+        const InstanceId* inserts = nullptr, const int* insertLengths = nullptr, int maxInserts = 0,
+        const InstanceId* insertPrevious = nullptr);
+
+    const std::vector<Node>& getNodes() const noexcept { return nodes; }
+    const std::vector<Edge>& getEdges() const noexcept { return edges; }
+
+    // Topologically sorts the graph into a schedule (message thread, allocates)
+    std::unique_ptr<const Schedule> compile() const;
+
+private:
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<Fade> fades;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RoutingGraph)
+};
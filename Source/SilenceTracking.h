@@ -0,0 +1,96 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Silence detection used to skip work on idle bands and hosted plugins
+namespace Silence
+{
+    // About -100 dBFS, quiet enough for a hosted plugin or reverb to sleep on (they fade back in when they wake).
+    // Only ever used to decide what may sleep, never to replace audio with zeros
+    constexpr float kThreshold = 1.0e-5f;
+
+    // Nothing but zeros and denormals below this, which no processing can tell apart from silence
+    constexpr float kDigitalSilence = std::numeric_limits<float>::min();
+
+    // Silent-sample counters stop here (about 6 hours at 48 kHz), so they never overflow
+    constexpr int kMaxCount = 1 << 30;
+
+    // Peak check over numChannels channels from firstChannel (getMagnitude runs on findMinAndMax, so it's vectorised)
+    inline bool isSilent(const juce::AudioBuffer<float>& buffer, int firstChannel, int numChannels, int numSamples)
+    {
+        for (int ch = firstChannel; ch < firstChannel + numChannels; ++ch)
+            if (buffer.getMagnitude(ch, 0, numSamples) >= kThreshold)
+                return false;
+
+        return true;
+    }
+
+    // Same check against kDigitalSilence, for bypasses that write zeros in place of the processed signal
+    inline bool isDigitalSilence(const juce::AudioBuffer<float>& buffer, int firstChannel, int numChannels, int numSamples)
+    {
+        for (int ch = firstChannel; ch < firstChannel + numChannels; ++ch)
+            if (buffer.getMagnitude(ch, 0, numSamples) >= kDigitalSilence)
+                return false;
+
+        return true;
+    }
+}
+
+// Decides when a hosted plugin can be put to sleep.
+//
+// A plugin keeps running while its input is live, for its reported tail once the input goes
+// quiet, and for as long as its output is still measurably decaying (plenty of plugins report
+// no tail at all). Once all of that is quiet it sleeps until input returns. The block it wakes
+// up on is flagged so the caller can fade its return in.
+class PluginActivity
+{
+public:
+    PluginActivity() = default;
+
+    void reset() noexcept
+    {
+        quietInputSamples = 0;
+        quietOutputSamples = 0;
+        asleep = false;
+        waking = false;
+    }
+
+    // Call before processing. Returns false if the plugin can stay asleep this block
+    bool beginBlock(bool inputSilent, int numSamples) noexcept
+    {
+        waking = false;
+
+        if (!inputSilent)
+        {
+            waking = asleep;
+            asleep = false;
+            quietInputSamples = 0;
+            return true;
+        }
+
+        if (asleep)
+            return false;
+
+        quietInputSamples = juce::jmin(quietInputSamples + numSamples, Silence::kMaxCount);
+        return true;
+    }
+
+    // Call after processing with the measured output. A tailSamples beyond Silence::kMaxCount means never sleep
+    void endBlock(bool outputSilent, int tailSamples, int holdSamples, int numSamples) noexcept
+    {
+        quietOutputSamples = outputSilent ? juce::jmin(quietOutputSamples + numSamples, Silence::kMaxCount) : 0;
+
+        if (quietInputSamples >= juce::jmax(tailSamples, holdSamples) && quietOutputSamples >= holdSamples)
+            asleep = true;
+    }
+
+    bool isAsleep() const noexcept { return asleep; }
+
+    // True for the first block processed after sleeping
+    bool isWaking() const noexcept { return waking; }
+
+private:
+    int quietInputSamples = 0;
+    int quietOutputSamples = 0;
+    bool asleep = false;
+    bool waking = false;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Linear per-sample gain ramp for the audio thread.
+//
+// Same behaviour as juce::SmoothedValue<float, Linear>, but a block of ramp values is written in
+// closed form (start + step * (i + 1)) rather than one getNextValue() call at a time. The loop has
+// no carried dependency, so it vectorises, and the ramp lands exactly on the target without
+// accumulating rounding error.
+class SmoothedGain
+{
+public:
+    SmoothedGain() = default;
+
+    // Sets the ramp length and jumps to the current target
+    void reset(double sampleRate, double rampSeconds) noexcept
+    {
+        stepsToTarget = juce::jmax(1, (int)std::floor(rampSeconds * sampleRate));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        current = target = newValue;
+        countdown = 0;
+    }
+
+    // Starts a new ramp from wherever the current one is (no-op if the target hasn't moved)
+    void setTargetValue(float newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+        countdown = stepsToTarget;
+        step = (target - current) / (float)countdown;
+    }
+
+    bool isSmoothing() const noexcept { return countdown > 0; }
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+
+    // Writes the next numSamples gain values to dest and advances the ramp by as much
+    void fillRamp(float* dest, int numSamples) noexcept
+    {
+        const auto ramped = juce::jmin(numSamples, countdown);
+        const auto start = current;
+        const auto delta = step;
+
+        for (int i = 0; i < ramped; ++i)
+            dest[i] = start + delta * (float)(i + 1);
+
+        if (ramped < numSamples)
+            juce::FloatVectorOperations::fill(dest + ramped, target, numSamples - ramped);
+
+        countdown -= ramped;
+        current = countdown == 0 ? target : start + delta * (float)ramped;
+    }
+
+    // Advances the ramp by numSamples without writing the values anywhere
+    void skip(int numSamples) noexcept
+    {
+        const auto ramped = juce::jmin(numSamples, countdown);
+
+        countdown -= ramped;
+        current = countdown == 0 ? target : current + step * (float)ramped;
+    }
+
+private:
+    float current = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int countdown = 0;
+    int stepsToTarget = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SmoothedGain)
+};
@@ -0,0 +1,252 @@
+#include "SpectralMorph.h"
+
+juce::StringArray SpectralMorph::getFftSizeNames()
+{
+    juce::StringArray names;
+    for (auto order : kFftOrders)
+        names.add(juce::String(1 << order));
+
+    return names;
+}
+
+juce::StringArray SpectralMorph::getHopNames()
+{
+    juce::StringArray names;
+    for (auto division : kHopDivisions)
+        names.add("1/" + juce::String(division) + " Frame");
+
+    return names;
+}
+
+SpectralMorph::SpectralMorph()
+{
+    for (int i = 0; i < kNumFftSizes; ++i)
+    {
+        ffts[i] = std::make_unique<juce::dsp::FFT>(kFftOrders[i]);
+
+        // sqrt of a periodic Hann window, so analysis * synthesis is a Hann window
+        const auto size = 1 << kFftOrders[i];
+        windows[i].resize((size_t)size);
+
+        for (int j = 0; j < size; ++j)
+            windows[i][(size_t)j] = (float)std::sin(juce::MathConstants<double>::pi * j / size);
+    }
+}
+
+void SpectralMorph::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    numLaneChannels = (int)spec.numChannels;
+
+    const auto ringSize = (size_t)(kMaxBands * numLaneChannels * kMaxFftSize);
+    inputRings.assign(ringSize, 0.0f);
+    targetRings.assign(ringSize, 0.0f);
+    outputRings.assign(ringSize, 0.0f);
+
+    sourceFrame.assign((size_t)(2 * kMaxFftSize), 0.0f);
+    targetFrame.assign((size_t)(2 * kMaxFftSize), 0.0f);
+
+    for (auto* bins : { &sourceRe, &sourceIm, &targetRe, &targetIm })
+        bins->assign((size_t)kMaxBins, 0.0f);
+
+    // The first process() call sets the sizes up
+    activeFftSize = -1;
+    activeHop = -1;
+    activeNumBands = 0;
+
+    reset();
+}
+
+void SpectralMorph::reset()
+{
+    for (auto* rings : { &inputRings, &targetRings, &outputRings })
+        std::fill(rings->begin(), rings->end(), 0.0f);
+
+    writePos = 0;
+    hopCount = 0;
+}
+
+int SpectralMorph::getLatencySamples(int fftSizeIndex) noexcept
+{
+    return 1 << kFftOrders[juce::jlimit(0, kNumFftSizes - 1, fftSizeIndex)];
+}
+
+void SpectralMorph::process(juce::AudioBuffer<float>& bands, const juce::AudioBuffer<float>& sidechain,
+    const BandSettings* settings, int numBands, int numChannels, int numSamples,
+    int fftSizeIndex, int hopIndex)
+{
+    fftSizeIndex = juce::jlimit(0, kNumFftSizes - 1, fftSizeIndex);
+    hopIndex = juce::jlimit(0, kNumHops - 1, hopIndex);
+    numBands = juce::jlimit(1, kMaxBands, numBands);
+    numChannels = juce::jmin(numChannels, numLaneChannels);
+
+    jassert(bands.getNumChannels() >= numBands * numChannels && bands.getNumSamples() >= numSamples);
+
+    // The rings only make sense for the layout they were filled with
+    if (fftSizeIndex != activeFftSize || hopIndex != activeHop || numBands != activeNumBands)
+    {
+        activeFftSize = fftSizeIndex;
+        activeHop = hopIndex;
+        activeNumBands = numBands;
+
+        fftSize = 1 << kFftOrders[fftSizeIndex];
+        hopSize = fftSize / kHopDivisions[hopIndex];
+        reset();
+    }
+
+    const auto sidechainChannels = juce::jmin(sidechain.getNumChannels(), numChannels);
+
+    bool morphing[kMaxBands] = {};
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto target = settings[band].target;
+        morphing[band] = (target >= 0 && target < numBands)
+            || (target == sidechainTarget && sidechainChannels > 0 && sidechain.getNumSamples() >= numSamples);
+    }
+
+    // Segments end at hop boundaries (where a frame runs) and at the end of the ring
+    for (int start = 0; start < numSamples;)
+    {
+        const auto n = juce::jmin(numSamples - start, hopSize - hopCount, fftSize - writePos);
+
+        // Targets first: a band can be another band's target and gets overwritten below
+        for (int band = 0; band < numBands; ++band)
+        {
+            if (!morphing[band])
+                continue;
+
+            const auto target = settings[band].target;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* src = target == sidechainTarget
+                    ? sidechain.getReadPointer(juce::jmin(ch, sidechainChannels - 1), start)
+                    : bands.getReadPointer(target * numChannels + ch, start);
+
+                auto* ring = targetRings.data() + (band * numLaneChannels + ch) * kMaxFftSize;
+                juce::FloatVectorOperations::copy(ring + writePos, src, n);
+            }
+        }
+
+        // Band in, finished overlap-add out (the output slot is cleared for the frames still to come)
+        for (int band = 0; band < numBands; ++band)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto offset = (band * numLaneChannels + ch) * kMaxFftSize + writePos;
+                auto* data = bands.getWritePointer(band * numChannels + ch, start);
+
+                juce::FloatVectorOperations::copy(inputRings.data() + offset, data, n);
+                juce::FloatVectorOperations::copy(data, outputRings.data() + offset, n);
+                juce::FloatVectorOperations::clear(outputRings.data() + offset, n);
+            }
+        }
+
+        writePos = (writePos + n) & (fftSize - 1);
+        hopCount += n;
+        start += n;
+
+        if (hopCount == hopSize)
+        {
+            hopCount = 0;
+            processFrames(settings, morphing, numBands, numChannels);
+        }
+    }
+}
+
+void SpectralMorph::readFrame(const float* ring, float* frame) const
+{
+    // The oldest sample sits at the write position
+    const auto* window = windows[activeFftSize].data();
+    const auto first = fftSize - writePos;
+
+    juce::FloatVectorOperations::multiply(frame, ring + writePos, window, first);
+    juce::FloatVectorOperations::multiply(frame + first, ring, window + first, writePos);
+}
+
+void SpectralMorph::processFrames(const BandSettings* settings, const bool* lanesMorphing, int numBands, int numChannels)
+{
+    const auto& fft = *ffts[activeFftSize];
+    const auto* window = windows[activeFftSize].data();
+    const auto numBins = fftSize / 2 + 1;
+    const auto first = fftSize - writePos;
+
+    // sqrt-Hann twice is a Hann window, which overlap-adds to fftSize / (2 * hop)
+    const auto overlapGain = 2.0f * (float)hopSize / (float)fftSize;
+
+    auto* frame = sourceFrame.data();
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto offset = (band * numLaneChannels + ch) * kMaxFftSize;
+
+            readFrame(inputRings.data() + offset, frame);
+
+            if (lanesMorphing[band])
+            {
+                readFrame(targetRings.data() + offset, targetFrame.data());
+
+                fft.performRealOnlyForwardTransform(frame, true);
+                fft.performRealOnlyForwardTransform(targetFrame.data(), true);
+
+                morphBins(frame, targetFrame.data(), numBins, settings[band].amount);
+
+                fft.performRealOnlyInverseTransform(frame);
+            }
+
+            // Synthesis window, then overlap-add starting at the frame's oldest sample
+            juce::FloatVectorOperations::multiply(frame, window, fftSize);
+
+            auto* out = outputRings.data() + offset;
+            juce::FloatVectorOperations::addWithMultiply(out + writePos, frame, overlapGain, first);
+            juce::FloatVectorOperations::addWithMultiply(out, frame + first, overlapGain, writePos);
+        }
+    }
+}
+
+void SpectralMorph::morphBins(float* source, const float* target, int numBins, float amount)
+{
+    amount = juce::jlimit(0.0f, 1.0f, amount);
+    const auto keep = 1.0f - amount;
+
+    auto* sRe = sourceRe.data();
+    auto* sIm = sourceIm.data();
+    auto* tRe = targetRe.data();
+    auto* tIm = targetIm.data();
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        sRe[k] = source[2 * k];
+        sIm[k] = source[2 * k + 1];
+        tRe[k] = target[2 * k];
+        tIm[k] = target[2 * k + 1];
+    }
+
+    // Branch-free and unit-stride, so this loop vectorises (sqrt and max have packed forms)
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto sourceMag = std::sqrt(sRe[k] * sRe[k] + sIm[k] * sIm[k]);
+        const auto targetMag = std::sqrt(tRe[k] * tRe[k] + tIm[k] * tIm[k]);
+
+        // Weighted sum of the two unit phasors (a silent bin just takes the other one's phase)
+        const auto sourceWeight = keep / std::max(sourceMag, kMinMagnitude);
+        const auto targetWeight = amount / std::max(targetMag, kMinMagnitude);
+
+        const auto re = sRe[k] * sourceWeight + tRe[k] * targetWeight;
+        const auto im = sIm[k] * sourceWeight + tIm[k] * targetWeight;
+
+        // Renormalised to the interpolated magnitude
+        const auto scale = (keep * sourceMag + amount * targetMag)
+            / std::max(std::sqrt(re * re + im * im), kMinMagnitude);
+
+        sRe[k] = re * scale;
+        sIm[k] = im * scale;
+    }
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        source[2 * k] = sRe[k];
+        source[2 * k + 1] = sIm[k];
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Spectral morph stage for the bands (short-time FFT with overlap-add).
+//
+// Every (band, channel) lane keeps a ring of its last FFT-size input samples. Once per hop each
+// lane with a target is windowed, transformed with a real FFT and morphed bin by bin towards the
+// same frame of its target (another band or the sidechain input). Magnitudes are interpolated
+// linearly and phases by interpolating the unit phasors and renormalising, so amount 0 gives the
+// band back and amount 1 gives the target's spectrum. The result is windowed again and
+// overlap-added into the lane's output ring.
+//
+// Analysis and synthesis both use a sqrt-Hann window, so the overlap-add is exact at every
+// supported hop. Lanes without a target skip the FFT and only go through the windowed
+// overlap-add, which gives them the same one-frame (FFT size) delay, so all bands stay aligned
+// and a target can come and go without a jump in timing.
+//
+// Rings, frame buffers, windows and the FFT plans for every size are allocated in prepare(), so
+// nothing allocates per frame. Changing the FFT size, hop or band count restarts from silence.
+class SpectralMorph
+{
+public:
+    static constexpr int kMaxBands = 8;
+
+    // BandSettings::target is a band index, or one of these
+    enum Target { noTarget = -1, sidechainTarget = kMaxBands };
+
+    struct BandSettings
+    {
+        int target = noTarget;
+        float amount = 0.0f;    // 0 = band, 1 = target
+    };
+
+    // Choices of the FFT size and hop parameters (index = parameter value)
+    static constexpr int kFftOrders[] = { 9, 10, 11, 12 };
+    static constexpr int kHopDivisions[] = { 2, 4, 8 };
+
+    static constexpr int kNumFftSizes = (int)std::size(kFftOrders);
+    static constexpr int kNumHops = (int)std::size(kHopDivisions);
+
+    static juce::StringArray getFftSizeNames();
+    static juce::StringArray getHopNames();
+
+    SpectralMorph();
+
+    // spec.numChannels is the channel count of one band
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // One frame of delay at the given FFT size
+    static int getLatencySamples(int fftSizeIndex) noexcept;
+
+    // Morphs numSamples of every band in place (bands laid out like BandSplitter's bands buffer).
+    // A band whose target is noTarget, a band outside numBands or a sidechain without channels
+    // is only delayed. sidechain may have any number of channels (extra band channels reuse
+    // its last one).
+    void process(juce::AudioBuffer<float>& bands, const juce::AudioBuffer<float>& sidechain,
+        const BandSettings* settings, int numBands, int numChannels, int numSamples,
+        int fftSizeIndex, int hopIndex);
+
+private:
+    static constexpr int kMaxFftSize = 1 << kFftOrders[kNumFftSizes - 1];
+    static constexpr int kMaxBins = kMaxFftSize / 2 + 1;
+
+    // Keeps tiny bins from blowing up the phasor normalisation
+    static constexpr float kMinMagnitude = 1.0e-9f;
+
+    // Runs the frame that ends at the current write position for every lane
+    void processFrames(const BandSettings* settings, const bool* lanesMorphing, int numBands, int numChannels);
+
+    // Morphs the source spectrum in place (both interleaved re/im, as the real FFT leaves them)
+    void morphBins(float* source, const float* target, int numBins, float amount);
+
+    // Copies the ring (starting at the write position) into frame, applying the window
+    void readFrame(const float* ring, float* frame) const;
+
+    int numLaneChannels = 0;
+
+    int activeFftSize = -1;
+    int activeHop = -1;
+    int activeNumBands = 0;
+
+    int fftSize = 0;
+    int hopSize = 0;
+    int writePos = 0;       // ring position of the next input sample (same for every lane)
+    int hopCount = 0;       // samples since the last frame
+
+    // One FFT plan per size
+    std::unique_ptr<juce::dsp::FFT> ffts[kNumFftSizes];
+
+    // sqrt-Hann window per FFT size
+    std::vector<float> windows[kNumFftSizes];
+
+    // kMaxBands * channels lanes of kMaxFftSize samples each (only fftSize of each is used)
+    std::vector<float> inputRings;
+    std::vector<float> targetRings;
+    std::vector<float> outputRings;
+
+    // FFT work buffers (the real transform needs twice the FFT size)
+    std::vector<float> sourceFrame;
+    std::vector<float> targetFrame;
+
+    // Split re/im copies of both spectra, so the per-bin maths runs over unit-stride arrays
+    std::vector<float> sourceRe, sourceIm, targetRe, targetIm;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralMorph)
+};
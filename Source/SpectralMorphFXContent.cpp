@@ -4,10 +4,46 @@ SpectralMorphFXContent::SpectralMorphFXContent(juce::AudioProcessorValueTreeStat
 {
     titleLabel.setText("Spectral Morph FX", juce::dontSendNotification);
     addAndMakeVisible(titleLabel);
+
+    // FFT size and hop (shared by every band)
+    fftSizeLabel.setText("FFT Size", juce::dontSendNotification);
+    hopLabel.setText("Hop", juce::dontSendNotification);
+    addAndMakeVisible(fftSizeLabel);
+    addAndMakeVisible(hopLabel);
+
+    attachChoice(apvts, "morphFftSize", fftSizeBox, fftSizeAttachment);
+    attachChoice(apvts, "morphHop", hopBox, hopAttachment);
+
+    // Band rows
+    for (int band = 0; band < XPulseAudioProcessor::kMaxBands; ++band)
+    {
+        bandLabels[band].setText("Band " + juce::String(band + 1), juce::dontSendNotification);
+        addAndMakeVisible(bandLabels[band]);
+
+        attachChoice(apvts, XPulseAudioProcessor::getMorphParamId(band, "Target"), targetBoxes[band], targetAttachments[band]);
+
+        amountSliders[band].setSliderStyle(juce::Slider::LinearHorizontal);
+        addAndMakeVisible(amountSliders[band]);
+        amountAttachments[band] = std::make_unique<SliderAttachment>(apvts, XPulseAudioProcessor::getMorphParamId(band, "Amount"), amountSliders[band]);
+    }
+
+    setSize(900, 300);
 }
 
 SpectralMorphFXContent::~SpectralMorphFXContent() {}
 
+void SpectralMorphFXContent::attachChoice(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramId,
+    juce::ComboBox& box, std::unique_ptr<ComboBoxAttachment>& attachment)
+{
+    addAndMakeVisible(box);
+
+    // The items have to be in the box before the attachment selects the current one
+    if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramId)))
+        box.addItemList(choiceParam->choices, 1);
+
+    attachment = std::make_unique<ComboBoxAttachment>(apvts, paramId, box);
+}
+
 void SpectralMorphFXContent::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::white);
@@ -16,4 +52,22 @@ void SpectralMorphFXContent::paint(juce::Graphics& g)
 void SpectralMorphFXContent::resized()
 {
     titleLabel.setBounds(10, 10, 200, 30);
+
+    fftSizeLabel.setBounds(220, 10, 70, 30);
+    fftSizeBox.setBounds(290, 10, 100, 30);
+    hopLabel.setBounds(400, 10, 40, 30);
+    hopBox.setBounds(440, 10, 120, 30);
+
+    // Two columns of band rows
+    const int rowsPerColumn = (XPulseAudioProcessor::kMaxBands + 1) / 2;
+
+    for (int band = 0; band < XPulseAudioProcessor::kMaxBands; ++band)
+    {
+        const int x = 10 + (band / rowsPerColumn) * 440;
+        const int y = 60 + (band % rowsPerColumn) * 55;
+
+        bandLabels[band].setBounds(x, y, 60, 30);
+        targetBoxes[band].setBounds(x + 60, y, 120, 30);
+        amountSliders[band].setBounds(x + 190, y, 230, 30);
+    }
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "PluginProcessor.h"
 
 class SpectralMorphFXContent : public juce::Component
 {
@@ -9,6 +10,26 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 private:
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+
+    //Fills a box with a choice parameter's choices and attaches it
+    void attachChoice(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramId,
+        juce::ComboBox& box, std::unique_ptr<ComboBoxAttachment>& attachment);
+
     juce::Label titleLabel;
+
+    //Shared FFT settings
+    juce::Label fftSizeLabel, hopLabel;
+    juce::ComboBox fftSizeBox, hopBox;
+    std::unique_ptr<ComboBoxAttachment> fftSizeAttachment, hopAttachment;
+
+    //One row per band: what it morphs towards and how far
+    juce::Label bandLabels[XPulseAudioProcessor::kMaxBands];
+    juce::ComboBox targetBoxes[XPulseAudioProcessor::kMaxBands];
+    juce::Slider amountSliders[XPulseAudioProcessor::kMaxBands];
+    std::unique_ptr<ComboBoxAttachment> targetAttachments[XPulseAudioProcessor::kMaxBands];
+    std::unique_ptr<SliderAttachment> amountAttachments[XPulseAudioProcessor::kMaxBands];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralMorphFXContent)
 };
@@ -1,4 +1,5 @@
 #include "SpectralMorphFXEditor.h"
+#include "SpectralMorphFXContent.h"
 
 SpectralMorphFXEditor::SpectralMorphFXEditor(juce::AudioProcessorValueTreeState& apvts)
     : juce::DocumentWindow("Spectral Morph FX Editor", juce::Colours::lightgrey, juce::DocumentWindow::allButtons)
@@ -7,6 +8,7 @@ SpectralMorphFXEditor::SpectralMorphFXEditor(juce::AudioProcessorValueTreeState&
     setResizable(true, false);
     setSize(900, 300);
     setVisible(true);
+    setContentOwned(new SpectralMorphFXContent(apvts), true);
 }
 
 SpectralMorphFXEditor::~SpectralMorphFXEditor() {}
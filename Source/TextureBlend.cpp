@@ -0,0 +1,293 @@
+#include "TextureBlend.h"
+
+TextureBlend::TextureBlend()
+{
+    // Hann envelope, with a trailing zero so phase 1 (and anything clamped to it) is silent
+    window.resize((size_t)kWindowSize + 1);
+    for (int j = 0; j < kWindowSize; ++j)
+        window[(size_t)j] = (float)(0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * j / kWindowSize));
+    window[(size_t)kWindowSize] = 0.0f;
+
+    for (auto& band : bandStates)
+        for (int grain = 0; grain < kMaxGrains; ++grain)
+            clearGrain(band, grain);
+}
+
+void TextureBlend::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // Room for the furthest a grain can lag the write head, plus the tile written ahead of it
+    const auto maxLag = (kMaxSprayMs + kMaxGrainMs) * 0.001 * sampleRate;
+    captureCapacity = juce::nextPowerOfTwo((int)std::ceil(maxLag) + 4 * kTileSize);
+    capture.assign((size_t)(kMaxBands * kMaxChannels * captureCapacity), 0.0f);
+
+    for (auto& band : bandStates)
+        band.mix.reset(sampleRate, 0.02);
+
+    reset();
+}
+
+void TextureBlend::reset()
+{
+    std::fill(capture.begin(), capture.end(), 0.0f);
+
+    for (auto& band : bandStates)
+    {
+        for (int grain = 0; grain < band.numGrains; ++grain)
+            clearGrain(band, grain);
+
+        band.numGrains = 0;
+        band.samplesToNextGrain = 0.0f;
+        band.writePos = 0;
+        band.capturedSamples = 0;
+        band.capturing = false;
+        band.mix.setCurrentAndTargetValue(0.0f);
+    }
+}
+
+bool TextureBlend::isActive(int band, float mix) const noexcept
+{
+    const auto& state = bandStates[band];
+    return mix > 0.0f || state.numGrains > 0 || state.mix.getCurrentValue() > 0.0f;
+}
+
+void TextureBlend::clearGrain(Band& band, int grain)
+{
+    // Past the end of its envelope and silent, wherever it ends up in a register
+    band.position[grain] = 0.0f;
+    band.increment[grain] = 0.0f;
+    band.phase[grain] = 2.0f;
+    band.phaseIncrement[grain] = 0.0f;
+    band.gainL[grain] = 0.0f;
+    band.gainR[grain] = 0.0f;
+}
+
+void TextureBlend::spawnGrain(Band& band, const BandSettings& settings, int tileStart, int offset, int numOutputs)
+{
+    if (band.numGrains >= kMaxGrains)
+        return;
+
+    const auto ratio = std::exp2(juce::jlimit(-kMaxPitchSemitones, kMaxPitchSemitones, settings.pitch) / 12.0);
+    const auto length = juce::jlimit(1.0, kMaxGrainMs * 0.001 * sampleRate, settings.grainMs * 0.001 * sampleRate);
+
+    // A grain playing faster than real time must start far enough back not to overtake the write head
+    const auto required = 1.0 + juce::jmax(0.0, (ratio - 1.0) * length);
+    const auto room = juce::jmax(0.0, (double)band.capturedSamples - required);
+    const auto spray = juce::jlimit(0.0f, kMaxSprayMs, settings.sprayMs) * 0.001 * sampleRate;
+    const auto delay = required + juce::jmin(room, spray * random.nextFloat());
+
+    // Wound back to the tile start, so the envelope opens exactly offset samples in
+    auto start = (double)(tileStart + offset) - delay - offset * ratio;
+    start -= captureCapacity * std::floor(start / captureCapacity);
+
+    const auto g = band.numGrains++;
+    band.position[g] = (float)start < (float)captureCapacity ? (float)start : 0.0f;
+    band.increment[g] = (float)ratio;
+    band.phase[g] = (float)(-offset / length);
+    band.phaseIncrement[g] = (float)(1.0 / length);
+
+    // Overlapping grains are uncorrelated, so scale for the expected power of the overlap
+    // (a Hann envelope averages 0.375 of full power)
+    const auto overlap = settings.density * length / sampleRate;
+    const auto level = (float)(1.0 / std::sqrt(juce::jmax(1.0, 0.375 * overlap)));
+
+    if (numOutputs > 1)
+    {
+        // Equal power pan, unity in the centre
+        const auto pan = juce::jlimit(0.0f, 1.0f, settings.spread) * (2.0f * random.nextFloat() - 1.0f);
+        const auto angle = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+
+        band.gainL[g] = level * juce::MathConstants<float>::sqrt2 * std::cos(angle);
+        band.gainR[g] = level * juce::MathConstants<float>::sqrt2 * std::sin(angle);
+    }
+    else
+    {
+        band.gainL[g] = level;
+        band.gainR[g] = 0.0f;
+    }
+}
+
+void TextureBlend::renderGrains(Band& band, const float* captureL, const float* captureR, float* left, float* right, int numSamples)
+{
+    const auto mask = captureCapacity - 1;
+    const auto capacity = Vec::expand((float)captureCapacity);
+    const auto tableScale = Vec::expand((float)kWindowSize);
+    const auto zero = Vec::expand(0.0f);
+    const auto one = Vec::expand(1.0f);
+
+    // Per-lane partial sums, reduced once per sample at the end
+    Vec accL[kTileSize], accR[kTileSize];
+    for (int i = 0; i < numSamples; ++i)
+        accL[i] = accR[i] = zero;
+
+    alignas(Vec::SIMDRegisterSize) float index[kLanes];
+    alignas(Vec::SIMDRegisterSize) float envIndex[kLanes];
+    alignas(Vec::SIMDRegisterSize) float env[kLanes];
+    alignas(Vec::SIMDRegisterSize) float l0[kLanes], l1[kLanes], r0[kLanes], r1[kLanes];
+
+    for (int g = 0; g < band.numGrains; g += kLanes)
+    {
+        auto position = Vec::fromRawArray(band.position + g);
+        auto phase = Vec::fromRawArray(band.phase + g);
+        const auto increment = Vec::fromRawArray(band.increment + g);
+        const auto phaseIncrement = Vec::fromRawArray(band.phaseIncrement + g);
+        const auto gainL = Vec::fromRawArray(band.gainL + g);
+        const auto gainR = Vec::fromRawArray(band.gainR + g);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto whole = Vec::truncate(position);
+            const auto frac = position - whole;
+
+            // Before the start and after the end both land on a zero of the table
+            Vec::truncate(Vec::min(Vec::max(phase, zero), one) * tableScale).copyToRawArray(envIndex);
+            whole.copyToRawArray(index);
+
+            for (int lane = 0; lane < kLanes; ++lane)
+            {
+                const auto p0 = (int)index[lane];
+                const auto p1 = (p0 + 1) & mask;
+
+                env[lane] = window[(size_t)envIndex[lane]];
+                l0[lane] = captureL[p0];
+                l1[lane] = captureL[p1];
+                r0[lane] = captureR[p0];
+                r1[lane] = captureR[p1];
+            }
+
+            const auto e = Vec::fromRawArray(env);
+            const auto sampleL = Vec::fromRawArray(l0) + (Vec::fromRawArray(l1) - Vec::fromRawArray(l0)) * frac;
+            const auto sampleR = Vec::fromRawArray(r0) + (Vec::fromRawArray(r1) - Vec::fromRawArray(r0)) * frac;
+
+            accL[i] += sampleL * e * gainL;
+            accR[i] += sampleR * e * gainR;
+
+            position += increment;
+            position = position - (capacity & Vec::greaterThanOrEqual(position, capacity));
+            phase += phaseIncrement;
+        }
+
+        position.copyToRawArray(band.position + g);
+        phase.copyToRawArray(band.phase + g);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        left[i] = accL[i].sum();
+        right[i] = accR[i].sum();
+    }
+}
+
+void TextureBlend::retireFinishedGrains(Band& band)
+{
+    // Swap the last live grain into each finished slot, so the live ones stay packed at the front
+    for (int g = band.numGrains - 1; g >= 0; --g)
+    {
+        if (band.phase[g] < 1.0f)
+            continue;
+
+        const auto last = --band.numGrains;
+
+        band.position[g] = band.position[last];
+        band.increment[g] = band.increment[last];
+        band.phase[g] = band.phase[last];
+        band.phaseIncrement[g] = band.phaseIncrement[last];
+        band.gainL[g] = band.gainL[last];
+        band.gainR[g] = band.gainR[last];
+
+        clearGrain(band, last);
+    }
+}
+
+void TextureBlend::process(const juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+    const BandSettings* settings, const bool* processBand,
+    int numBands, int numChannels, int numSamples)
+{
+    numBands = juce::jlimit(1, kMaxBands, numBands);
+    const auto numCh = juce::jmin(numChannels, (int)kMaxChannels);
+    const auto numOutputs = juce::jmin(numCh, output.getNumChannels());
+    const auto mask = captureCapacity - 1;
+
+    jassert(bands.getNumChannels() >= numBands * numChannels && bands.getNumSamples() >= numSamples);
+
+    float left[kTileSize], right[kTileSize], mixRamp[kTileSize];
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        auto& band = bandStates[b];
+
+        if (!processBand[b])
+        {
+            band.capturing = false;
+            continue;
+        }
+
+        // Whatever is in the capture from before doesn't belong to this run
+        if (!band.capturing)
+        {
+            band.capturing = true;
+            band.capturedSamples = 0;
+        }
+
+        const auto& s = settings[b];
+        band.mix.setTargetValue(s.mix);
+
+        auto* captureL = capture.data() + (size_t)(b * kMaxChannels * captureCapacity);
+        auto* captureR = numCh > 1 ? captureL + captureCapacity : captureL;
+        float* captures[kMaxChannels] = { captureL, captureR };
+
+        const auto grainInterval = sampleRate / juce::jmax(1.0f, s.density);
+
+        for (int start = 0; start < numSamples; start += kTileSize)
+        {
+            const auto n = juce::jmin(kTileSize, numSamples - start);
+            const auto tileStart = band.writePos;
+
+            // Capture first, so grains can read right up to the newest sample
+            const auto first = juce::jmin(n, captureCapacity - tileStart);
+            for (int ch = 0; ch < numCh; ++ch)
+            {
+                const auto* src = bands.getReadPointer(b * numChannels + ch, start);
+                juce::FloatVectorOperations::copy(captures[ch] + tileStart, src, first);
+                juce::FloatVectorOperations::copy(captures[ch], src + first, n - first);
+            }
+
+            band.writePos = (tileStart + n) & mask;
+            band.capturedSamples = juce::jmin(band.capturedSamples + n, captureCapacity);
+
+            // New grains at random intervals averaging the density (none while the mix is off)
+            if (s.mix > 0.0f || s.mixOffsets != nullptr)
+            {
+                while (band.samplesToNextGrain < (float)n)
+                {
+                    spawnGrain(band, s, tileStart, (int)band.samplesToNextGrain, numOutputs);
+                    band.samplesToNextGrain += (float)(grainInterval * (0.5 + random.nextFloat()));
+                }
+
+                band.samplesToNextGrain -= (float)n;
+            }
+
+            if (band.numGrains == 0)
+            {
+                band.mix.skip(n);
+                continue;
+            }
+
+            renderGrains(band, captureL, captureR, left, right, n);
+            band.mix.fillRamp(mixRamp, n);
+
+            if (s.mixOffsets != nullptr)
+            {
+                juce::FloatVectorOperations::add(mixRamp, s.mixOffsets + start, n);
+                juce::FloatVectorOperations::clip(mixRamp, mixRamp, 0.0f, 1.0f, n);
+            }
+
+            juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(0, start), left, mixRamp, n);
+            if (numOutputs > 1)
+                juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(1, start), right, mixRamp, n);
+
+            retireFinishedGrains(band);
+        }
+    }
+}
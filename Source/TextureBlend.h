@@ -0,0 +1,117 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BandSplitter.h"
+#include "SmoothedGain.h"
+
+// Granular texture for the bands (texture blend FX).
+//
+// Each textured band is recorded into a circular capture buffer, and grains read back out of it:
+// a grain starts a random distance behind the write head (spray), plays at its own pitch under a
+// Hann envelope and is panned at random within the spread. The grains of a band are summed and
+// added to the output on top of the dry mix, scaled by the band's mix level.
+//
+// Grains live in a fixed pool per band, kept in SoA form with the live grains packed at the
+// front, so spawning is a write into the next free slot and a finished grain is swapped out with
+// the last live one. Nothing allocates after prepare(). The synthesis runs kLanes grains at a time
+// in SIMD registers over 64-sample tiles; only the capture and envelope table reads are scalar.
+class TextureBlend
+{
+public:
+    static constexpr int kMaxBands = BandSplitter::kMaxBands;
+    static constexpr int kMaxChannels = 2;
+
+    // Grains per band (spawns are dropped while a band's pool is full)
+    static constexpr int kMaxGrains = 512;
+
+    // Parameter limits the capture buffer is sized for
+    static constexpr float kMaxGrainMs = 500.0f;
+    static constexpr float kMaxSprayMs = 500.0f;
+    static constexpr float kMaxPitchSemitones = 12.0f;
+
+    struct BandSettings
+    {
+        float mix = 0.0f;
+        float grainMs = 80.0f;
+        float density = 50.0f;      // grains per second
+        float pitch = 0.0f;         // semitones
+        float sprayMs = 100.0f;     // how far behind the write head grains may start
+        float spread = 0.5f;        // 0 = centre, 1 = full width
+
+        // Optional per-sample offsets on the mix (numSamples long), clamped to 0..1
+        const float* mixOffsets = nullptr;
+    };
+
+    TextureBlend();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // False once a band sits at zero mix with no grains left, so it doesn't need capturing
+    bool isActive(int band, float mix) const noexcept;
+
+    // Captures the bands flagged in processBand (BandSplitter's band-major layout) and adds their
+    // grains into output. A band that comes back after being inactive only sprays over what it
+    // has captured since.
+    void process(const juce::AudioBuffer<float>& bands, juce::AudioBuffer<float>& output,
+        const BandSettings* settings, const bool* processBand,
+        int numBands, int numChannels, int numSamples);
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int kLanes = (int)Vec::SIMDNumElements;
+
+    static_assert(kMaxGrains % kLanes == 0, "The pool must fill whole registers");
+
+    // Samples per synthesis tile (the accumulators live on the stack)
+    static constexpr int kTileSize = 64;
+
+    // Envelope table resolution (one extra zero entry catches phase 1)
+    static constexpr int kWindowSize = 2048;
+
+    struct Band
+    {
+        // Grain pool, [0, numGrains) are live. The rest have zero gain, so partly filled
+        // registers at the end just add silence
+        alignas(Vec::SIMDRegisterSize) float position[kMaxGrains];    // capture read position
+        alignas(Vec::SIMDRegisterSize) float increment[kMaxGrains];   // playback rate
+        alignas(Vec::SIMDRegisterSize) float phase[kMaxGrains];       // envelope position, 0..1
+        alignas(Vec::SIMDRegisterSize) float phaseIncrement[kMaxGrains];
+        alignas(Vec::SIMDRegisterSize) float gainL[kMaxGrains];
+        alignas(Vec::SIMDRegisterSize) float gainR[kMaxGrains];
+        int numGrains = 0;
+
+        float samplesToNextGrain = 0.0f;
+        int writePos = 0;
+        int capturedSamples = 0;
+        bool capturing = false;
+
+        SmoothedGain mix;
+    };
+
+    void clearGrain(Band& band, int grain);
+
+    // Starts a grain offset samples into the current tile (tileStart is the write position at the tile start)
+    void spawnGrain(Band& band, const BandSettings& settings, int tileStart, int offset, int numOutputs);
+
+    // Sums every live grain of a band for one tile into left/right
+    void renderGrains(Band& band, const float* captureL, const float* captureR, float* left, float* right, int numSamples);
+
+    void retireFinishedGrains(Band& band);
+
+    double sampleRate = 44100.0;
+
+    // Per-channel capacity (power of two, so positions wrap with a mask)
+    int captureCapacity = 0;
+
+    // kMaxBands * kMaxChannels capture buffers of captureCapacity samples each
+    std::vector<float> capture;
+
+    // Hann envelope, kWindowSize + 1 entries
+    std::vector<float> window;
+
+    juce::Random random;
+
+    Band bandStates[kMaxBands];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextureBlend)
+};
@@ -1,13 +1,48 @@
 #include "TextureBlendFXContent.h"
 
 TextureBlendFXContent::TextureBlendFXContent(juce::AudioProcessorValueTreeState& apvts)
+    : apvtsRef(apvts)
 {
     titleLabel.setText("Texture Blend FX", juce::dontSendNotification);
     addAndMakeVisible(titleLabel);
+
+    // Band selector (the sliders follow it)
+    for (int band = 0; band < XPulseAudioProcessor::kMaxBands; ++band)
+        bandBox.addItem("Band " + juce::String(band + 1), band + 1);
+
+    bandBox.onChange = [this]() { attachBand(bandBox.getSelectedItemIndex()); };
+    addAndMakeVisible(bandBox);
+
+    for (int i = 0; i < kNumControls; ++i)
+    {
+        controlLabels[i].setText(kControlNames[i], juce::dontSendNotification);
+        addAndMakeVisible(controlLabels[i]);
+
+        controlSliders[i].setSliderStyle(juce::Slider::LinearHorizontal);
+        addAndMakeVisible(controlSliders[i]);
+    }
+
+    bandBox.setSelectedId(1, juce::sendNotificationSync);
+
+    setSize(900, 300);
 }
 
 TextureBlendFXContent::~TextureBlendFXContent() {}
 
+void TextureBlendFXContent::attachBand(int band)
+{
+    if (band < 0)
+        return;
+
+    for (int i = 0; i < kNumControls; ++i)
+    {
+        // The old attachment has to let go of the slider before the new one takes it
+        controlAttachments[i].reset();
+        controlAttachments[i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvtsRef,
+            XPulseAudioProcessor::getTextureParamId(band, kControlNames[i]), controlSliders[i]);
+    }
+}
+
 void TextureBlendFXContent::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::white);
@@ -16,4 +51,11 @@ void TextureBlendFXContent::paint(juce::Graphics& g)
 void TextureBlendFXContent::resized()
 {
     titleLabel.setBounds(10, 10, 200, 30);
+    bandBox.setBounds(220, 10, 120, 30);
+
+    for (int i = 0; i < kNumControls; ++i)
+    {
+        controlLabels[i].setBounds(10, 60 + i * 35, 80, 30);
+        controlSliders[i].setBounds(90, 60 + i * 35, 400, 30);
+    }
 }
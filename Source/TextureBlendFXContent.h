@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "PluginProcessor.h"
 
 class TextureBlendFXContent : public juce::Component
 {
@@ -9,6 +10,23 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
 private:
+    //Points the sliders at the selected band's parameters
+    void attachBand(int band);
+
+    juce::AudioProcessorValueTreeState& apvtsRef;
+
     juce::Label titleLabel;
+
+    //Band being edited
+    juce::ComboBox bandBox;
+
+    //Mix, Size, Density, Pitch, Spray, Spread (same order as kControlNames)
+    static constexpr int kNumControls = 6;
+    static constexpr const char* kControlNames[kNumControls] = { "Mix", "Size", "Density", "Pitch", "Spray", "Spread" };
+
+    juce::Label controlLabels[kNumControls];
+    juce::Slider controlSliders[kNumControls];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> controlAttachments[kNumControls];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextureBlendFXContent)
 };
@@ -1,4 +1,5 @@
 #include "TextureBlendFXEditor.h"
+#include "TextureBlendFXContent.h"
 
 TextureBlendFXEditor::TextureBlendFXEditor(juce::AudioProcessorValueTreeState& apvts)
     : juce::DocumentWindow("Texture Blend FX Editor", juce::Colours::lightgrey, juce::DocumentWindow::allButtons)
@@ -7,6 +8,7 @@ TextureBlendFXEditor::TextureBlendFXEditor(juce::AudioProcessorValueTreeState& a
     setResizable(true, false);
     setSize(900, 300);
     setVisible(true);
+    setContentOwned(new TextureBlendFXContent(apvts), true);
 }
 
 TextureBlendFXEditor::~TextureBlendFXEditor() {}
@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    Console runner for the DSP unit tests. The tests live next to the classes
+    they cover (the *Tests.cpp files in Source) and are only compiled into
+    this target, never into the plugin.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // Some of the classes under test post to the message thread or start their own threads
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+
+    // A test name on the command line runs just that test, otherwise everything in the category
+    if (argc > 1)
+        runner.runTestsWithName (argv[1]);
+    else
+        runner.runTestsInCategory ("XPulse");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult (i)->failures;
+
+    // Non-zero when anything failed, so a build step can gate on it
+    return failures > 0 ? 1 : 0;
+}